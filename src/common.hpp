@@ -4,6 +4,8 @@
 #include <ndn-cxx/util/io.hpp>
 #include <ndn-cxx/face.hpp>
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <vector>
 #include <utility>
@@ -46,7 +48,23 @@ enum
   mGuardContent = 127,
   mGuardPublisher = 128,
   mGuardController = 129,
-  mGuardControllerKey = 130
+  mGuardControllerKey = 130,
+  // 131 is unused
+  mGuardManifestPrefix = 132,
+  mGuardManifestEntry = 133,
+  mGuardManifestIndex = 134,
+  mGuardIndexStartTime = 135,
+  mGuardIndexEndTime = 136,
+  mGuardIndexFirstSeq = 137,
+  mGuardIndexLastSeq = 138,
+  mGuardCheckpoint = 139,
+  mGuardCheckpointStream = 140,
+  mGuardCheckpointManifestSeq = 141,
+  mGuardCheckpointIndexSeq = 142,
+  mGuardCheckpointLastPublished = 143,
+  mGuardCheckpointPending = 144,
+  mGuardCatalog = 145,
+  mGuardCatalogVersion = 146
 };
 
 }
@@ -59,13 +77,266 @@ if use_manifest is set to false, manifest will not be used, application data wil
 */
 const bool USE_MANIFEST = true;
 
+/*
+if digest auth is set to true, data packets are only digest signed and authenticated through the (signed) manifest:
+subscriber fetches each data packet by the full name (i.e. with implicit digest) listed in the manifest,
+such that only that exact packet can satisfy the interest, instead of validating the packet individually.
+*/
+const bool USE_MANIFEST_DIGEST_AUTH = true;
+
+/*
+if compact manifest is set to true, the prefix shared by all entries (i.e. the stream prefix) is encoded
+once and each entry only carries its suffix (timestamp and implicit digest)
+*/
+const bool USE_COMPACT_MANIFEST = true;
+
 // manifest will be published after receiving 50 data units
 const int MANIFEST_BATCH_SIZE = 50;
 
 // if next update is not received withing 200 ms, the manifest will be publised, this can override batch size
-const ndn::time::milliseconds MAX_UPDATE_WAIT_TIME(100); //todo: not implemented yet
+const ndn::time::milliseconds MAX_UPDATE_WAIT_TIME(100);
+
+// manifest will be published once the entries (encoded names) reach this size
+const size_t MANIFEST_BATCH_BYTES = 6000;
+
+// manifest is split into segments of this size, i.e. /<stream>/MANIFEST/<seq>/<version>/<segment>
+const size_t MANIFEST_SEGMENT_SIZE = 7000;
+
+// segment contents are copied into this many reusable buffers before signing
+const size_t SEGMENT_BUFFER_POOL_SIZE = 8;
+
+// initial congestion window (number of segment interests) for fetching a manifest
+const int MANIFEST_FETCH_WINDOW = 4;
+
+// manifest will be published at the latest this long after its first entry was added
+const ndn::time::milliseconds MAX_MANIFEST_AGE(1000);
+
+/*
+if adaptive batching is set to true, the batch size of each stream follows the measured arrival rate
+such that a manifest covers about MANIFEST_TARGET_LATENCY worth of data (bounded by MANIFEST_BATCH_SIZE),
+low-rate streams are flushed right away and high-rate streams are batched
+*/
+const bool USE_ADAPTIVE_BATCHING = true;
+const ndn::time::milliseconds MANIFEST_TARGET_LATENCY(500);
+
+// resolution of the manifest flush deadlines (timer wheel tick)
+const ndn::time::milliseconds MANIFEST_FLUSH_TICK(10);
+
+/*
+manifests published within the same interval (aligned to the wall clock) are indexed by one index object,
+/<stream>/MANIFEST/INDEX/<index-seq>, which is published once the first manifest of the next interval is out.
+Consumers binary search the index to start at a given time instead of fetching all the manifests
+*/
+const ndn::time::milliseconds MANIFEST_INDEX_INTERVAL = ndn::time::minutes(1);
 
 // manifest ---------
+
+// manifest signing ---------
+/*
+PRODUCER: manifests are signed with the producer (RSA) key, as the data
+ECDSA: manifests are signed with an ECDSA key of the producer identity, certified by the producer key
+HMAC: manifests are signed with a shared key, only for trusted local repos/consumers
+*/
+enum class ManifestSigner { PRODUCER, ECDSA, HMAC };
+const ManifestSigner MANIFEST_SIGNER = ManifestSigner::ECDSA;
+
+// issuer id of the manifest signing certificate
+const std::string MANIFEST_CERT_ISSUER = "mguard-manifest";
+
+// base64 encoded shared key, used only if MANIFEST_SIGNER is HMAC
+const std::string MANIFEST_HMAC_KEY_PATH = "certs/manifest-hmac.key";
+
+inline
+std::string
+loadHmacKey(const std::string& keyPath)
+{
+  std::ifstream input_file(keyPath);
+  if (!input_file.is_open())
+    NDN_THROW(std::runtime_error("Failed to read HMAC key file: " + keyPath));
+
+  std::string key;
+  input_file >> key;
+  return key;
+}
+// manifest signing ---------
+
+// abe precomputation ---------
+// content keys are prepared once the producer has not published anything for this long
+const ndn::time::milliseconds PRECOMPUTE_IDLE_TIME(500);
+// abe precomputation ---------
+
+// content cache ---------
+// freshly produced packets are served by the producer until the repo has them
+const size_t CONTENT_CACHE_CAPACITY = 32 * 1024 * 1024; // bytes
+const ndn::time::milliseconds CONTENT_CACHE_TTL = ndn::time::seconds(30);
+// packets are kept this long after the repo write completed, for Interests in flight
+const ndn::time::milliseconds CONTENT_CACHE_STORED_GRACE = ndn::time::seconds(2);
+// content cache ---------
+
+// native repo ---------
+/*
+if use native repo is set to true, packets are stored by an embedded repo (log structured store at
+NATIVE_REPO_PATH) in the producer process and served on the producer's face, otherwise they are sent
+over TCP to a repo, i.e. ndn-python-repo or the standalone mguard-repo
+*/
+const bool USE_NATIVE_REPO = false;
+const std::string NATIVE_REPO_PATH = "repo-storage";
+
+// storage shards of the native repo (<NATIVE_REPO_PATH>/shard-<n>), e.g. symlinked to separate disks
+const size_t NATIVE_REPO_SHARDS = 1;
+
+// a new log segment is started once the active one reaches this size
+const size_t REPO_SEGMENT_SIZE = 64 * 1024 * 1024;
+
+// appended packets are flushed to disk at least this often
+const ndn::time::milliseconds REPO_SYNC_INTERVAL(1000);
+// native repo ---------
+
+// startup ---------
+/*
+the producer opens ingest once the repo connection is attempted, the attribute authority answered
+with its public parameters and the producer prefix is registered, and gives up after this long
+*/
+const ndn::time::milliseconds STARTUP_TIMEOUT = ndn::time::seconds(10);
+
+// the public parameters interest is retried after this long if the attribute authority doesn't answer,
+// and the encrypting producer is checked again at this interval until it has the public parameters
+const ndn::time::milliseconds PUBLIC_PARAMS_RETRY_INTERVAL(500);
+// startup ---------
+
+// checkpoint ---------
+/*
+per-stream producer state (sync sequence numbers, manifest entries not published yet, open index bucket)
+is kept in this file, such that a restarted producer continues the sequence numbers instead of
+starting over. It is rewritten (temp file + rename) before a sync update goes out, other changes
+(e.g. new manifest entries) are written at most CHECKPOINT_SAVE_INTERVAL later
+*/
+const std::string PRODUCER_CHECKPOINT_PATH = "producer.checkpoint";
+const ndn::time::milliseconds CHECKPOINT_SAVE_INTERVAL(1000);
+// checkpoint ---------
+
+// sync state ---------
+/*
+the IBF of the partial producer is sized from the sync prefixes (stream, manifest and index names)
+and the bloom filter of the consumer from its subscriptions, with headroom such that the IBF still
+decodes after every prefix changed. Both are rebuilt once the count outgrows the size, the consumer
+also once it drops below a quarter of it
+*/
+const size_t SYNC_MIN_IBF_SIZE = 40;
+const size_t SYNC_MIN_SUBSCRIPTIONS = 3;
+const size_t SYNC_SIZE_HEADROOM = 2;
+const double SYNC_BLOOM_FPR = 0.001;
+
+// sequence numbers published within this window go to the sync in one update, zero disables it
+const ndn::time::milliseconds SYNC_COALESCE_WINDOW(20);
+
+// a consumer without sync updates for this long refreshes the producer IBF with a hello interest
+const ndn::time::milliseconds SYNC_HELLO_REFRESH_INTERVAL = ndn::time::seconds(30);
+
+inline
+size_t
+getSyncStateSize(size_t nEntries, size_t minSize)
+{
+  return std::max(minSize, nEntries * SYNC_SIZE_HEADROOM);
+}
+
+/*
+streams are synced in groups, one per participant and stream class, such that a busy stream only
+wakes up the consumers of its group. The top-level group under the sync prefix announces a version
+of every group, bumped when the group gets new prefixes or its IBF is resized.
+A group is named by the components of the stream name that follow the sync prefix, at most this many
+and never the last one (the stream itself)
+*/
+const size_t SYNC_GROUP_COMPONENTS = 3;
+
+/**
+ * @brief Sync prefix of the group of a stream
+ *  e.g. /ndn/org/md2k/mguard/dd40c/phone/gps -> /ndn/org/md2k/SYNC/mguard/dd40c/phone
+*/
+inline
+ndn::Name
+getSyncGroupPrefix(const ndn::Name& syncPrefix, const ndn::Name& streamName)
+{
+  size_t begin = syncPrefix.isPrefixOf(streamName) ? syncPrefix.size() : 0;
+  size_t end = streamName.size() > begin ? std::min(begin + SYNC_GROUP_COMPONENTS, streamName.size() - 1)
+                                         : begin;
+
+  ndn::Name groupPrefix(syncPrefix);
+  groupPrefix.append("SYNC");
+  for (size_t i = begin; i < end; ++i)
+    groupPrefix.append(streamName.get(i));
+  return groupPrefix;
+}
+// sync state ---------
+
+// stream catalog ---------
+/*
+the producer publishes the names of its streams as a signed dataset under
+<producer-prefix>/CATALOG/<version>, the version is announced in the top-level sync group
+under <producer-prefix>/CATALOG. Streams showing up in ingest are added to it at runtime,
+updates within this delay go into one version
+*/
+const std::string STREAM_CATALOG_COMPONENT = "CATALOG";
+const ndn::time::milliseconds CATALOG_UPDATE_DELAY(100);
+
+/*
+consumers keep a notification interest <producer-prefix>/CATALOG/NOTIFY/<known-version> pending at
+the producer, answered with the latest version as soon as it is newer. Unreachable producers (nack)
+are retried with exponential backoff
+*/
+const std::string CATALOG_NOTIFY_COMPONENT = "NOTIFY";
+const ndn::time::milliseconds CATALOG_NOTIFY_LIFETIME = ndn::time::seconds(30);
+const ndn::time::milliseconds CATALOG_NOTIFY_RETRY_MIN_DELAY(100);
+const ndn::time::milliseconds CATALOG_NOTIFY_RETRY_MAX_DELAY = ndn::time::seconds(30);
+// pending notification interests kept by the producer, the oldest are dropped beyond this
+const size_t CATALOG_NOTIFY_MAX_PENDING = 10000;
+// stream catalog ---------
+
+// retention ---------
+// packets are expired (per-stream TTLs from the retention section of the mapping file) and their
+// space is reclaimed by a background sweep, each sweep of a store expires at most
+// RETENTION_EXPIRE_BATCH due packets (another sweep follows right away if there were more) and
+// reads/writes at most RETENTION_COMPACT_BYTES
+const ndn::time::milliseconds RETENTION_SWEEP_INTERVAL(1000);
+const size_t RETENTION_EXPIRE_BATCH = 1000;
+const size_t RETENTION_COMPACT_BYTES = 4 * 1024 * 1024;
+// retention ---------
+
+// repo writes ---------
+// number of TCP connections to the repo, packets of a stream always go through the same connection
+const size_t REPO_CONNECTION_POOL_SIZE = 2;
+
+// packets queued for the repo are written in batches of up to this many bytes
+const size_t REPO_WRITE_BATCH_BYTES = 64 * 1024;
+
+// a packet waits at most this long for its batch to fill up (when no write is in flight)
+const ndn::time::milliseconds REPO_WRITE_MAX_DELAY(2);
+
+// an unreachable repo is retried after this delay, doubled on every failure up to the max
+const ndn::time::milliseconds REPO_RECONNECT_MIN_DELAY(100);
+const ndn::time::milliseconds REPO_RECONNECT_MAX_DELAY = ndn::time::seconds(30);
+
+// packets that can't be written are spilled to <SPILL_JOURNAL_PATH>/connection-<n>.journal
+const std::string SPILL_JOURNAL_PATH = "spill-journal";
+
+// spilled packets are replayed at most this many bytes per interval, live packets go first
+const size_t REPO_REPLAY_BATCH_BYTES = 256 * 1024;
+const ndn::time::milliseconds REPO_REPLAY_INTERVAL(10);
+// repo writes ---------
+
+// ingest ---------
+// batches submitted through a PublisherHandle wait in a queue of this many batches
+const size_t INGEST_QUEUE_CAPACITY = 1024;
+
+// at most this many batches are published per round on the io thread, then other events get a turn
+const size_t INGEST_DRAIN_BATCH = 64;
+
+// a blocking submit to a full queue yields this many times, then sleeps doubling up to the max
+const int INGEST_SUBMIT_SPINS = 64;
+const std::chrono::microseconds INGEST_SUBMIT_MIN_BACKOFF(10);
+const std::chrono::microseconds INGEST_SUBMIT_MAX_BACKOFF(1000);
+// ingest ---------
+
 const std::string SEMANTIC_LOCATION = "ndn--org--md2k--mguard--dd40c--data_analysis--gps_episodes_and_semantic_location";
 const std::string NDN_LOCATION_STREAM = "/ndn/org/md2k/mguard/dd40c/phone/gps";
 const std::string NDN_BATTERY_STREAM = "/ndn/org/md2k/mguard/dd40c/phone/battery";
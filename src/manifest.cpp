@@ -0,0 +1,206 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "manifest.hpp"
+#include "common.hpp"
+
+#include <ndn-cxx/security/signing-helpers.hpp>
+
+#include <algorithm>
+
+namespace mguard {
+namespace manifest {
+
+ndn::Name
+getCommonPrefix(const std::vector<ndn::Name>& entries)
+{
+  if (entries.empty())
+    return {};
+
+  size_t length = entries.front().size();
+  for (const auto& entry : entries) {
+    length = std::min(length, entry.size());
+  }
+  // keep at least one component in every suffix
+  length = length > 0 ? length - 1 : 0;
+
+  const auto& first = entries.front();
+  for (const auto& entry : entries) {
+    size_t i = 0;
+    while (i < length && entry.get(i) == first.get(i))
+      ++i;
+    length = i;
+  }
+  return first.getPrefix(length);
+}
+
+static ndn::Name
+decodeComponents(const ndn::Block& block)
+{
+  block.parse();
+  ndn::Name name;
+  for (const auto& element : block.elements()) {
+    name.append(ndn::name::Component(element));
+  }
+  return name;
+}
+
+ManifestEntries::ManifestEntries(const ndn::Block& wire)
+{
+  wire.parse();
+  bool hasPrefix = false;
+  for (const auto& element : wire.elements()) {
+    switch (element.type()) {
+      case ndn::tlv::Name:
+        m_entries.push_back(element);
+        break;
+      case mguard::tlv::mGuardManifestEntry:
+        if (!hasPrefix)
+          NDN_THROW(ndn::tlv::Error("Manifest entry suffix without preceding prefix"));
+        m_entries.push_back(element);
+        break;
+      case mguard::tlv::mGuardManifestPrefix:
+        m_prefix = decodeComponents(element);
+        hasPrefix = true;
+        break;
+      default:
+        NDN_THROW(ndn::tlv::Error("Expected Name element, but TLV has type " +
+                                  ndn::to_string(element.type())));
+    }
+  }
+}
+
+ndn::Name
+ManifestEntries::get(size_t i) const
+{
+  const auto& entry = m_entries.at(i);
+  if (entry.type() == ndn::tlv::Name)
+    return ndn::Name(entry);
+
+  auto name = m_prefix;
+  name.append(decodeComponents(entry));
+  return name;
+}
+
+ndn::Block
+ManifestIndex::wireEncode() const
+{
+  ndn::EncodingBuffer encoder;
+  size_t totalLength = 0;
+  totalLength += ndn::encoding::prependNonNegativeIntegerBlock(encoder, mguard::tlv::mGuardIndexLastSeq, lastSeq);
+  totalLength += ndn::encoding::prependNonNegativeIntegerBlock(encoder, mguard::tlv::mGuardIndexFirstSeq, firstSeq);
+  totalLength += ndn::encoding::prependNonNegativeIntegerBlock(encoder, mguard::tlv::mGuardIndexEndTime,
+                                                               ndn::time::toUnixTimestamp(endTime).count());
+  totalLength += ndn::encoding::prependNonNegativeIntegerBlock(encoder, mguard::tlv::mGuardIndexStartTime,
+                                                               ndn::time::toUnixTimestamp(startTime).count());
+  encoder.prependVarNumber(totalLength);
+  encoder.prependVarNumber(mguard::tlv::mGuardManifestIndex);
+  return encoder.block();
+}
+
+void
+ManifestIndex::wireDecode(const ndn::Block& wire)
+{
+  if (wire.type() != mguard::tlv::mGuardManifestIndex)
+    NDN_THROW(ndn::tlv::Error("Expected ManifestIndex, but TLV has type " + ndn::to_string(wire.type())));
+
+  wire.parse();
+  auto readField = [&wire] (uint32_t type) {
+    auto it = wire.find(type);
+    if (it == wire.elements_end())
+      NDN_THROW(ndn::tlv::Error("ManifestIndex is missing TLV type " + ndn::to_string(type)));
+    return ndn::encoding::readNonNegativeInteger(*it);
+  };
+
+  startTime = ndn::time::fromUnixTimestamp(ndn::time::milliseconds(readField(mguard::tlv::mGuardIndexStartTime)));
+  endTime = ndn::time::fromUnixTimestamp(ndn::time::milliseconds(readField(mguard::tlv::mGuardIndexEndTime)));
+  firstSeq = readField(mguard::tlv::mGuardIndexFirstSeq);
+  lastSeq = readField(mguard::tlv::mGuardIndexLastSeq);
+}
+
+ndn::Block
+StreamCatalog::wireEncode() const
+{
+  ndn::EncodingBuffer encoder;
+  size_t totalLength = 0;
+  for (auto it = streams.rbegin(); it != streams.rend(); ++it) {
+    totalLength += it->wireEncode(encoder);
+  }
+  totalLength += ndn::encoding::prependNonNegativeIntegerBlock(encoder, mguard::tlv::mGuardCatalogVersion, version);
+  encoder.prependVarNumber(totalLength);
+  encoder.prependVarNumber(mguard::tlv::mGuardCatalog);
+  return encoder.block();
+}
+
+void
+StreamCatalog::wireDecode(const ndn::Block& wire)
+{
+  if (wire.type() != mguard::tlv::mGuardCatalog)
+    NDN_THROW(ndn::tlv::Error("Expected StreamCatalog, but TLV has type " + ndn::to_string(wire.type())));
+
+  wire.parse();
+  auto it = wire.elements_begin();
+  if (it == wire.elements_end() || it->type() != mguard::tlv::mGuardCatalogVersion)
+    NDN_THROW(ndn::tlv::Error("StreamCatalog is missing the version"));
+  version = ndn::encoding::readNonNegativeInteger(*it);
+
+  streams.clear();
+  for (++it; it != wire.elements_end(); ++it) {
+    if (it->type() != ndn::tlv::Name)
+      NDN_THROW(ndn::tlv::Error("Expected Name element, but TLV has type " + ndn::to_string(it->type())));
+    streams.emplace(*it);
+  }
+}
+
+ndn::security::Certificate
+getManifestCertificate(ndn::KeyChain& keyChain, const ndn::security::Certificate& producerCert)
+{
+  auto identityName = ndn::security::extractIdentityFromCertName(producerCert.getName());
+  auto identity = keyChain.getPib().getIdentity(identityName);
+
+  // reuse the manifest key from an earlier run if there is one
+  for (const auto& key : identity.getKeys()) {
+    if (key.getKeyType() != ndn::KeyType::EC)
+      continue;
+    for (const auto& cert : key.getCertificates()) {
+      if (cert.getIssuerId() == ndn::name::Component(MANIFEST_CERT_ISSUER) && cert.isValid())
+        return cert;
+    }
+  }
+
+  auto key = keyChain.createKey(identity, ndn::EcKeyParams());
+
+  ndn::security::Certificate cert;
+  auto certName = key.getName();
+  certName.append(MANIFEST_CERT_ISSUER).appendVersion();
+  cert.setName(certName);
+  cert.setContent(key.getPublicKey());
+  cert.setFreshnessPeriod(ndn::time::hours(1));
+
+  // certified by the producer key, covered by the trust schema
+  ndn::SignatureInfo signatureInfo;
+  signatureInfo.setValidityPeriod(ndn::security::ValidityPeriod(ndn::time::system_clock::now(),
+                                    ndn::time::system_clock::now() + ndn::time::days(365)));
+  keyChain.sign(cert, ndn::security::signingByCertificate(producerCert).setSignatureInfo(signatureInfo));
+  keyChain.addCertificate(key, cert);
+  return cert;
+}
+
+} // manifest
+} // mguard
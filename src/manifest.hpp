@@ -0,0 +1,158 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MGUARD_MANIFEST_HPP
+#define MGUARD_MANIFEST_HPP
+
+#include <ndn-cxx/name.hpp>
+#include <ndn-cxx/encoding/buffer.hpp>
+#include <ndn-cxx/encoding/block-helpers.hpp>
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
+#include <ndn-cxx/security/key-chain.hpp>
+#include <ndn-cxx/util/time.hpp>
+
+#include <set>
+#include <vector>
+
+namespace mguard {
+namespace manifest {
+
+/*
+  Helpers shared by the publisher (manifest encoding) and the subscriber (manifest decoding)
+*/
+
+/**
+ * @brief Get the longest prefix shared by all entries (compact manifest)
+ *
+ *  The prefix is kept at least one component shorter than the shortest entry, such that
+ *  each entry still has a suffix (at least the implicit digest) of its own.
+ * @param entries data names in manifest order
+*/
+ndn::Name
+getCommonPrefix(const std::vector<ndn::Name>& entries);
+
+/**
+ * @brief Prepend the components of name, starting from component index from, as a TLV of given type
+ *
+ *  Used for the compact manifest, i.e. mGuardManifestPrefix with the common prefix and
+ *  mGuardManifestEntry with the suffix of each entry.
+*/
+template <ndn::encoding::Tag TAG>
+size_t
+prependComponents(ndn::EncodingImpl<TAG>& encoder, uint32_t type, const ndn::Name& name, size_t from = 0)
+{
+  size_t totalLength = 0;
+  for (size_t i = name.size(); i > from; --i) {
+    totalLength += ndn::encoding::prependBlock(encoder, name.get(i - 1));
+  }
+  totalLength += encoder.prependVarNumber(totalLength);
+  totalLength += encoder.prependVarNumber(type);
+  return totalLength;
+}
+
+/**
+ * @brief Entries of a received manifest (mGuardPublisher block)
+ *
+ *  Entries are either full names or, in the compact form, suffixes of a common prefix. Compact
+ *  entries are kept as they are on the wire and only expanded into a name when accessed.
+*/
+class ManifestEntries
+{
+public:
+  /**
+   * @brief Parse the manifest
+   * @param wire mGuardPublisher block
+   * @throw ndn::tlv::Error if the block contains unexpected elements
+  */
+  explicit
+  ManifestEntries(const ndn::Block& wire);
+
+  size_t
+  size() const
+  {
+    return m_entries.size();
+  }
+
+  /**
+   * @brief Get the full data name of the i-th entry
+  */
+  ndn::Name
+  get(size_t i) const;
+
+private:
+  ndn::Name m_prefix;
+  std::vector<ndn::Block> m_entries; // Name or mGuardManifestEntry blocks
+};
+
+/**
+ * @brief Index over the manifests of a stream published within one time bucket
+ *  (manifest of manifests), published under /<stream>/MANIFEST/INDEX/<index-seq>
+ *
+ *  Manifest sequence numbers are consecutive, thus the range is enough to list them.
+*/
+struct ManifestIndex
+{
+  ndn::time::system_clock::time_point startTime; // publication time of the first manifest
+  ndn::time::system_clock::time_point endTime;   // publication time of the last manifest
+  uint64_t firstSeq = 0;
+  uint64_t lastSeq = 0;
+
+  ndn::Block
+  wireEncode() const;
+
+  /**
+   * @throw ndn::tlv::Error if the block is not a valid mGuardManifestIndex
+  */
+  void
+  wireDecode(const ndn::Block& wire);
+};
+
+/*
+  Names of the streams of a producer, fetched by consumers under <producer-prefix>/CATALOG/<version>
+  and followed through the version announced by the top-level sync group
+*/
+struct StreamCatalog
+{
+  uint64_t version = 0;
+  std::set<ndn::Name> streams;
+
+  ndn::Block
+  wireEncode() const;
+
+  /**
+   * @throw ndn::tlv::Error if the block is not a valid mGuardCatalog
+  */
+  void
+  wireDecode(const ndn::Block& wire);
+};
+
+/**
+ * @brief Get the ECDSA manifest signing certificate of the producer (MANIFEST_SIGNER = ECDSA)
+ *
+ *  A valid certificate issued by MANIFEST_CERT_ISSUER for an EC key of the producer identity is
+ *  reused from an earlier run. Otherwise a new EC key is created, certified by the producer key
+ *  (covered by the trust schema) and added to the key chain.
+*/
+ndn::security::Certificate
+getManifestCertificate(ndn::KeyChain& keyChain, const ndn::security::Certificate& producerCert);
+
+} // manifest
+} // mguard
+
+#endif // MGUARD_MANIFEST_HPP
@@ -30,6 +30,7 @@
 
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/json_parser.hpp>
+#include <boost/algorithm/string.hpp>
 
 NDN_LOG_INIT(mguard.DataAdapter);
 
@@ -157,24 +158,74 @@ DataAdapter::DataAdapter(ndn::Face& face, const ndn::Name& producerPrefix,
 , m_producerCert(*loadCert(producerCertPath))
 , m_ABE_authorityCert(*loadCert(aaCertPath))
 , m_attrMappingProcessor(attributeMappintFilePath)
+, m_retentionPolicy(m_attrMappingProcessor.getRetentionPolicy())
 , m_publisher(m_face, m_keyChain, m_producerPrefix, m_producerCert,
               m_ABE_authorityCert, m_attrMappingProcessor.getStreamNames())
-, m_receiver(m_face.getIoService(), 
-             std::bind(&DataAdapter::processCallbackFromReceiver, this, _1, _2, _3))
 , m_dataBase(lookupDatabase)
+, m_ingestQueue(std::make_shared<IngestQueue>(m_face.getIoService(), INGEST_QUEUE_CAPACITY))
 {
   NDN_LOG_DEBUG ("Initialized data adaptor and publisher");
   NDN_LOG_DEBUG ("---------------------------------------------");
   NDN_LOG_DEBUG ("Producer cert: " << m_producerCert);
   NDN_LOG_DEBUG ("---------------------------------------------");
   NDN_LOG_DEBUG ("ABE authority cert: " << m_ABE_authorityCert);
+
+  addExpectedAttributesFromMapping();
+  m_publisher.setRetentionPolicy(m_retentionPolicy);
+
+  m_publisher.whenReady(std::bind(&DataAdapter::openIngest, this),
+                        [] (const std::string& reason) {
+                          NDN_THROW(Error("Producer failed to start, " + reason));
+                        });
+}
+
+void
+DataAdapter::openIngest()
+{
+  NDN_LOG_INFO("Producer is ready, accepting data");
+  m_receiver = std::make_unique<Receiver>(m_face.getIoService(),
+                                          std::bind(&DataAdapter::processCallbackFromReceiver, this, _1, _2, _3));
+  m_ingestQueue->start([this] (IngestBatch& batch) {
+    processBatch(batch.streamName, batch.metaData, batch.rows);
+  });
+}
+
+void
+DataAdapter::addExpectedAttributesFromMapping()
+{
+  // stream id -> stream name (ndn uri), ids are written as "1," in the mapping file
+  std::map<std::string, std::string> idToStream;
+  for (const auto& it : m_attrMappingProcessor.getStreamNamesWithId()) {
+    auto id = it.first;
+    boost::trim_right_if(id, boost::is_any_of(","));
+    auto streamUri = ndn::Name(it.second).toUri();
+    idToStream.emplace(id, streamUri);
+
+    // metadata and rows without context attribute are encrypted with the stream name only
+    m_publisher.addExpectedAttributes({streamUri});
+  }
+
+  for (const auto& it : m_attrMappingProcessor.getMappingTable()) {
+    if (it.second.columnInSource != "semantic_location" || it.first.empty())
+      continue;
+
+    // e.g. /attribtues/location/home -> /ndn/org/md2k/ATTRIBUTE/location/home
+    auto semLocAttr = mguard::util::getNdnNameFromSemanticLocationName(it.first.get(-1).toUri());
+    for (const auto& id : it.second.appliedTo) {
+      auto streamItr = idToStream.find(boost::trim_copy(id));
+      if (streamItr == idToStream.end())
+        continue;
+      NDN_LOG_TRACE("Expected attributes: " << streamItr->second << ", " << semLocAttr);
+      m_publisher.addExpectedAttributes({streamItr->second, semLocAttr.toUri()});
+    }
+  }
 }
 
 ndn::Name
-DataAdapter::makeDataName(ndn::Name streamName, std::string timestamp)
+DataAdapter::makeDataName(ndn::Name streamName, std::string timestamp, uint64_t metadataVersion)
 {
   NDN_LOG_TRACE("Creating data name from streamName: " << streamName << " and timestamp: " << timestamp);
-  return streamName.append("DATA").append(timestamp);
+  return streamName.append("DATA").append(timestamp).appendVersion(metadataVersion);
 }
 
 void
@@ -182,16 +233,83 @@ DataAdapter::processCallbackFromReceiver(const std::string& streamName, const st
                                          const std::string& streamContent)
 {
   NDN_LOG_DEBUG("Received data from the receiver for streamName: " << streamName);
-  auto content = m_fileProcessor.getVectorByDelimiter(streamContent, "\n", 1);
+  processBatch(streamName, metaData, m_fileProcessor.getVectorByDelimiter(streamContent, "\n", 1));
+}
 
+void
+DataAdapter::processBatch(const std::string& streamName, const std::string& metaData,
+                          const std::vector<std::string>& rows)
+{
   if (streamName == SEMANTIC_LOCATION) {
     // insert the data into the lookup table
     NDN_LOG_DEBUG("Received semantic location data");
-    m_dataBase.insertRows(content);
+    m_dataBase.insertRows(rows);
+    expireLookupRows();
   }
 
-  auto streamNDNName = std::regex_replace(streamName, std::regex("--"), "/"); // convert to ndn name
-  publishDataUnit(streamNDNName, metaData, content);
+  publishDataUnit(internStream(streamName), metaData, rows);
+}
+
+uint64_t
+DataAdapter::publishMetadata(util::InternedId streamId, const std::string& metaData)
+{
+  const auto& streamName = m_publisher.getNameInterner().getName(streamId);
+  auto version = m_metadataVersions.prepare(streamId, metaData);
+  if (!version) {
+    NDN_LOG_TRACE("Metadata of " << streamName << " unchanged, version: " << m_metadataVersions.getVersion(streamId));
+    return m_metadataVersions.getVersion(streamId);
+  }
+
+  // naming /<stream-name>/metadata/<version>
+  auto metaDataName = streamName;
+  metaDataName.append("metadata").appendVersion(*version);
+  if (!m_publisher.publish(metaDataName, metaData, {streamId}, streamId)) {
+    // tried again with the next batch, the rows still refer to the last published version
+    return m_metadataVersions.getVersion(streamId);
+  }
+
+  NDN_LOG_DEBUG("Published metadata: " << metaDataName);
+  m_metadataVersions.commit(streamId, *version);
+  return *version;
+}
+
+util::InternedId
+DataAdapter::internStream(const std::string& streamName)
+{
+  auto it = m_streamIds.find(streamName);
+  if (it != m_streamIds.end())
+    return it->second;
+
+  ndn::Name streamNDNName(std::regex_replace(streamName, std::regex("--"), "/")); // convert to ndn name
+  auto id = m_publisher.getNameInterner().intern(streamNDNName);
+  m_streamIds.emplace(streamName, id);
+  return id;
+}
+
+util::InternedId
+DataAdapter::internSemanticLocation(const std::string& location)
+{
+  auto it = m_semanticLocationIds.find(location);
+  if (it != m_semanticLocationIds.end())
+    return it->second;
+
+  auto id = m_publisher.getNameInterner().intern(mguard::util::getNdnNameFromSemanticLocationName(location));
+  m_semanticLocationIds.emplace(location, id);
+  return id;
+}
+
+void
+DataAdapter::expireLookupRows()
+{
+  const auto& semanticLocationStream = m_publisher.getNameInterner().getName(internStream(SEMANTIC_LOCATION));
+  auto ttl = m_retentionPolicy.getTtl(semanticLocationStream);
+  if (!ttl)
+    return;
+
+  // same clock as the insertion time, the data time of the rows may be far in the past
+  auto cutoff = ndn::time::toUnixTimestamp(ndn::time::system_clock::now() - *ttl).count();
+  NDN_LOG_DEBUG("Deleting lookup rows inserted before: " << cutoff);
+  m_dataBase.deleteRows("inserted < " + std::to_string(cutoff));
 }
 
 void
@@ -215,21 +333,17 @@ DataAdapter::stop()
 }
 
 void
-DataAdapter::publishDataUnit(ndn::Name streamName, const std::string& metaData,
+DataAdapter::publishDataUnit(util::InternedId streamId, const std::string& metaData,
                              const std::vector<std::string>& dataSet)
 {
+  const auto& streamName = m_publisher.getNameInterner().getName(streamId);
   NDN_LOG_INFO("Processing stream: " << streamName);
 
-  // first process/publish the metadata
-  auto metaDataName = streamName;
-  // version number will be extracted from the metaData itself.
-  // right now the information is not available there
-  // naming /<stream-name>/metadata/<version-number>
-  metaDataName.append("metadata/v1");
-  m_publisher.publish(metaDataName, metaData, {streamName.toUri()}, streamName);
+  // first process/publish the metadata, if it changed since the last batch
+  auto metadataVersion = publishMetadata(streamId, metaData);
 
   // next, process/publish each individual data stream
-  for (auto data : dataSet)
+  for (const auto& data : dataSet)
   {
     char timestamp [80];
     struct tm tm;
@@ -247,7 +361,7 @@ DataAdapter::publishDataUnit(ndn::Name streamName, const std::string& metaData,
       NDN_LOG_DEBUG("Converted timestamp format: " << timestamp);
     }
 
-    auto dataName = makeDataName(streamName, timestamp);
+    auto dataName = makeDataName(streamName, timestamp, metadataVersion);
     NDN_LOG_DEBUG ("Publishing data name: " << dataName << " with timestamp: " << timestamp);
 
     /*
@@ -255,14 +369,13 @@ DataAdapter::publishDataUnit(ndn::Name streamName, const std::string& metaData,
       solution is to implement a 'getAttribute' function that can check all possible
       lookups and retrieve all attributes that will be applied
     */
-    std::vector<std::string> attrList= {streamName.toUri()};
+    m_attributes.assign(1, streamId);
     try {
       auto semAttr = m_dataBase.getSemanticLocations(std::string(timestamp));
       if (!semAttr.empty()){
         for (auto& attr: semAttr) {
-          auto _semLocAttr = mguard::util::getNdnNameFromSemanticLocationName(attr);
-          NDN_LOG_TRACE("Semanantic location attribute: " << _semLocAttr);
-          attrList.push_back(_semLocAttr.toUri());
+          NDN_LOG_TRACE("Semanantic location attribute: " << attr);
+          m_attributes.push_back(internSemanticLocation(attr));
         }
       }
       else {
@@ -274,7 +387,7 @@ DataAdapter::publishDataUnit(ndn::Name streamName, const std::string& metaData,
     }
 
     // std::optional<ndn::Name> name = streamName;
-    m_publisher.publish(dataName, data, attrList, streamName);
+    m_publisher.publish(dataName, data, m_attributes, streamId);
   }
 }
 
@@ -21,9 +21,11 @@
 #define MGUARD_DATA_ADAPTER_HPP
 
 #include "publisher.hpp"
+#include "publisher-handle.hpp"
 #include "file-processor.hpp"
 #include "util/stream.hpp"
 #include "util/database.hpp"
+#include "util/metadata-versions.hpp"
 
 #include <PSync/full-producer.hpp>
 #include <nac-abe/attribute-authority.hpp>
@@ -141,6 +143,12 @@ public:
               const std::string& producerCertPath, const ndn::Name& aaPrefix,
               const std::string& aaCertPath, const std::string& lookupDatabase,
               const std::string& availableStreamFilePath);
+
+  ~DataAdapter()
+  {
+    // drains posted for the handles must not reach a destroyed adapter
+    m_ingestQueue->stop();
+  }
   
   void
   run();
@@ -148,17 +156,78 @@ public:
   void
   stop();
 
-  ndn::Name
-  makeDataName(ndn::Name streamName, std::string timestamp);
+  /**
+   * @brief Handle for submitting batches from other threads, they are published once the
+   *  producer is ready, in the order they were queued (see PublisherHandle)
+  */
+  PublisherHandle
+  getHandle()
+  {
+    return PublisherHandle(m_ingestQueue);
+  }
+
+  /**
+   * @brief /<stream-name>/DATA/<timestamp>/<metadata-version>, the version of the metadata
+   *  the row was produced under, see publishMetadata()
+  */
+  static ndn::Name
+  makeDataName(ndn::Name streamName, std::string timestamp, uint64_t metadataVersion);
 
   void
   processCallbackFromReceiver(const std::string& streamName, const std::string& metaData,
                               const std::string& streamContent);
+
+  /**
+   * @brief Publish the rows of a batch, rows of the semantic location stream also go into the lookup table
+   * @param streamName stream name as the receiver gets it (e.g. ndn--org--md2k--...)
+  */
+  void
+  processBatch(const std::string& streamName, const std::string& metaData,
+               const std::vector<std::string>& rows);
   
   void
-  publishDataUnit(ndn::Name streamName, const std::string& metaData,
+  publishDataUnit(util::InternedId streamId, const std::string& metaData,
                   const std::vector<std::string>& dataSet);
 
+private:
+  /*
+    Derive the attribute sets that publishDataUnit is going to use from the attribute mapping
+    table, so the publisher can prepare their content keys while idle
+  */
+  void
+  addExpectedAttributesFromMapping();
+
+  /*
+    Delete the lookup rows inserted longer than the TTL of the semantic location stream ago, the
+    rows are no longer needed once its data is expired. Insertion time, not the data time of the
+    rows, replayed or historical data would be deleted right after its insertion otherwise
+  */
+  void
+  expireLookupRows();
+
+  // start accepting data from the data generator
+  void
+  openIngest();
+
+  /*
+    Publish the metadata (header) of a batch as /<stream-name>/metadata/<version> if its content
+    differs from the last published one (see MetadataVersions), it rarely changes between
+    batches. Returns the version of the current metadata of the stream.
+  */
+  uint64_t
+  publishMetadata(util::InternedId streamId, const std::string& metaData);
+
+  /*
+    Id of the ndn name of a stream name of the receiver (e.g. ndn--org--md2k--...), the name
+    is only converted the first time
+  */
+  util::InternedId
+  internStream(const std::string& streamName);
+
+  // id of the attribute name of a semantic location (e.g. home)
+  util::InternedId
+  internSemanticLocation(const std::string& location);
+
 private:
   ndn::KeyChain m_keyChain;
   ndn::Face& m_face;
@@ -170,12 +239,19 @@ private:
   ndn::security::Certificate m_producerCert;
   ndn::security::Certificate m_ABE_authorityCert;
   AttributeMappingFileProcessor m_attrMappingProcessor;
+  repo::RetentionPolicy m_retentionPolicy;
 
   mguard::Publisher m_publisher;
   boost::asio::io_service m_ioService;
-  mguard::Receiver m_receiver;
+  std::unique_ptr<mguard::Receiver> m_receiver; // once the publisher is ready
   std::map<std::string, mguard::util::Stream> m_streams;
+  std::unordered_map<std::string, util::InternedId> m_streamIds;
+  std::unordered_map<std::string, util::InternedId> m_semanticLocationIds;
+  std::vector<util::InternedId> m_attributes; // of the row being published, reused
+
+  util::MetadataVersions m_metadataVersions;
   db::DataBase m_dataBase;
+  std::shared_ptr<IngestQueue> m_ingestQueue; // shared with the handles
 };
 
 } // mguard
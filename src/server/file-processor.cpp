@@ -113,6 +113,8 @@ AttributeMappingFileProcessor::processAttributeMappingFile()
 				ret = processStreamsSection(tn.second);
 			else if (tn.first == "attribute-mapping")
 				ret = processMappingSection(tn.second);
+			else if (tn.first == "retention")
+				ret = processRetentionSection(tn.second);
 		}
 	}
 	catch (const boost::property_tree::info_parser_error &error)
@@ -173,4 +175,41 @@ AttributeMappingFileProcessor::processMappingSection(const MappingSection& secti
   return ret;
 }
 
+bool
+AttributeMappingFileProcessor::processRetentionSection(const MappingSection& section)
+{
+  try {
+    for (auto& it : section)
+    {
+      auto ttl = ndn::time::hours(section.get<uint64_t>(it.first));
+      if (it.first == "default")
+        m_defaultRetention = ttl;
+      else
+        m_retention[boost::trim_right_copy_if(it.first, boost::is_any_of(","))] = ttl;
+      std::cout << "retention of: " << it.first << " " << ttl << std::endl;
+    }
+  }
+  catch (const std::exception &ex)
+  {
+    std::cerr << "Invalid retention section: " << ex.what() << std::endl;
+    return false;
+  }
+  return true;
+}
+
+repo::RetentionPolicy
+AttributeMappingFileProcessor::getRetentionPolicy() const
+{
+  repo::RetentionPolicy policy;
+  if (m_defaultRetention)
+    policy.setDefaultTtl(*m_defaultRetention);
+
+  for (const auto& it : m_streams) {
+    auto ttl = m_retention.find(boost::trim_right_copy_if(it.first, boost::is_any_of(",")));
+    if (ttl != m_retention.end())
+      policy.setTtl(it.second, ttl->second);
+  }
+  return policy;
+}
+
 } // mguard
@@ -22,6 +22,7 @@
 #define MGUARD_FILE_PROCESSOR_HPP
 
 #include "../common.hpp"
+#include "repo/retention-policy.hpp"
 
 #include <ndn-cxx/face.hpp>
 
@@ -30,6 +31,7 @@
 
 #include <iostream>
 #include <map>
+#include <optional>
 
 namespace mguard {
 
@@ -73,6 +75,13 @@ public:
     return m_mappingTable;
   }
 
+  /*
+    TTLs of the retention section, by stream name. Streams without an entry get the default
+    entry if there is one, otherwise they are kept forever
+  */
+  repo::RetentionPolicy
+  getRetentionPolicy() const;
+
   /*read stream saved in csv file and return data in a vector, per row*/
   std::vector<std::string>
   readStream(std::string streamName);
@@ -85,10 +94,15 @@ public:
   bool
   processMappingSection(const MappingSection &section);
 
+  bool
+  processRetentionSection(const MappingSection &section);
+
 private:
   const std::string& m_filename;
   std::map<std::string, std::string> m_streams;
   std::map<ndn::Name, mguard::AttributeMappingTable> m_mappingTable;
+  std::map<std::string, ndn::time::hours> m_retention; // stream id -> TTL
+  std::optional<ndn::time::hours> m_defaultRetention;
 
 };
 
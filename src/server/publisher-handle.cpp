@@ -0,0 +1,119 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "publisher-handle.hpp"
+#include "../common.hpp"
+
+#include <ndn-cxx/util/logger.hpp>
+
+#include <thread>
+
+NDN_LOG_INIT(mguard.PublisherHandle);
+
+namespace mguard {
+
+IngestQueue::IngestQueue(boost::asio::io_service& io, size_t capacity)
+: m_io(io)
+, m_queue(capacity)
+{
+}
+
+bool
+IngestQueue::tryPush(IngestBatch&& batch)
+{
+  if (!m_queue.tryPush(std::move(batch)))
+    return false;
+
+  m_nSubmitted.fetch_add(1, std::memory_order_relaxed);
+  scheduleDrain();
+  return true;
+}
+
+void
+IngestQueue::scheduleDrain()
+{
+  // pairs with the exchange in drain(), either the pending drain sees the batch or a new one is posted
+  if (m_isDrainScheduled.exchange(true, std::memory_order_seq_cst))
+    return;
+
+  m_io.post([self = shared_from_this()] { self->drain(); });
+}
+
+void
+IngestQueue::start(const IngestCallback& onBatch)
+{
+  m_onBatch = onBatch;
+  NDN_LOG_DEBUG("Publishing submitted batches, " << m_queue.size() << " queued");
+  drain();
+}
+
+void
+IngestQueue::drain()
+{
+  // batches queued from now on post the next drain
+  m_isDrainScheduled.exchange(false, std::memory_order_seq_cst);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (!m_onBatch) // start() drains
+    return;
+
+  IngestBatch batch;
+  size_t nDrained = 0;
+  while (nDrained < INGEST_DRAIN_BATCH && m_queue.tryPop(batch)) {
+    m_onBatch(batch);
+    ++nDrained;
+  }
+
+  if (nDrained == INGEST_DRAIN_BATCH) {
+    NDN_LOG_TRACE("Drained " << nDrained << " batches, " << m_queue.size() << " left for the next round");
+    scheduleDrain();
+  }
+}
+
+PublisherHandle::PublisherHandle(std::shared_ptr<IngestQueue> queue)
+: m_queue(std::move(queue))
+{
+}
+
+bool
+PublisherHandle::submit(std::string streamName, std::string metaData, std::vector<std::string> rows,
+                        SubmitMode mode)
+{
+  IngestBatch batch{std::move(streamName), std::move(metaData), std::move(rows)};
+  if (m_queue->tryPush(std::move(batch)))
+    return true;
+
+  m_queue->onRejected();
+  if (mode == SubmitMode::NON_BLOCKING)
+    return false;
+
+  // no lock to wait on, the io thread is given time to drain
+  auto delay = INGEST_SUBMIT_MIN_BACKOFF;
+  for (int nTries = 0; !m_queue->tryPush(std::move(batch)); ++nTries) {
+    if (nTries < INGEST_SUBMIT_SPINS) {
+      std::this_thread::yield();
+    }
+    else {
+      std::this_thread::sleep_for(delay);
+      delay = std::min(delay * 2, INGEST_SUBMIT_MAX_BACKOFF);
+    }
+  }
+  return true;
+}
+
+} // mguard
@@ -0,0 +1,162 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MGUARD_PUBLISHER_HANDLE_HPP
+#define MGUARD_PUBLISHER_HANDLE_HPP
+
+#include "util/mpsc-queue.hpp"
+
+#include <boost/asio/io_service.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mguard {
+
+// a batch of rows of a stream, as the receiver gets it from the data generator
+struct IngestBatch
+{
+  std::string streamName; // e.g. ndn--org--md2k--mguard--dd40c--phone--gps
+  std::string metaData;
+  std::vector<std::string> rows;
+};
+
+using IngestCallback = std::function<void(IngestBatch& batch)>;
+
+/*
+  Batches submitted from any thread, published on the io thread of the face.
+
+  Batches go into a bounded lock-free MpscQueue. A drain is posted to the io service only if none
+  is pending, so the io service (which takes a lock) is woken once per burst instead of once per
+  batch. A drain round publishes at most INGEST_DRAIN_BATCH batches and posts the next round if
+  more are queued, the face isn't starved by busy producers.
+*/
+class IngestQueue : public std::enable_shared_from_this<IngestQueue>, boost::noncopyable
+{
+public:
+  IngestQueue(boost::asio::io_service& io, size_t capacity);
+
+  /**
+   * @brief Queue a batch, from any thread
+   * @return false if the queue is full, the batch is left untouched then
+  */
+  bool
+  tryPush(IngestBatch&& batch);
+
+  /**
+   * @brief Start handing the batches to onBatch, on the io thread. Batches submitted before
+   *  wait in the queue (producers are held back once it is full).
+  */
+  void
+  start(const IngestCallback& onBatch);
+
+  // stop handing out batches, on the io thread
+  void
+  stop()
+  {
+    m_onBatch = nullptr;
+  }
+
+  size_t
+  capacity() const
+  {
+    return m_queue.capacity();
+  }
+
+  uint64_t
+  getSubmittedCount() const
+  {
+    return m_nSubmitted.load(std::memory_order_relaxed);
+  }
+
+  // submits that found the queue full
+  uint64_t
+  getRejectedCount() const
+  {
+    return m_nRejected.load(std::memory_order_relaxed);
+  }
+
+  void
+  onRejected()
+  {
+    m_nRejected.fetch_add(1, std::memory_order_relaxed);
+  }
+
+private:
+  void
+  scheduleDrain();
+
+  void
+  drain();
+
+private:
+  boost::asio::io_service& m_io;
+  util::MpscQueue<IngestBatch> m_queue;
+  std::atomic<bool> m_isDrainScheduled{false};
+  IngestCallback m_onBatch; // only used on the io thread
+  std::atomic<uint64_t> m_nSubmitted{0};
+  std::atomic<uint64_t> m_nRejected{0};
+};
+
+enum class SubmitMode {
+  BLOCKING,     // wait while the queue is full
+  NON_BLOCKING, // give up if the queue is full
+};
+
+/*
+  Thread-safe entry point to a DataAdapter for applications producing data on their own threads,
+  see DataAdapter::getHandle(). Handles are cheap to copy and can be shared by any number of
+  threads, the batches are published in the order they were queued. The DataAdapter must outlive
+  the handles.
+*/
+class PublisherHandle
+{
+public:
+  explicit
+  PublisherHandle(std::shared_ptr<IngestQueue> queue);
+
+  /**
+   * @brief Queue a batch of rows for publication, from any thread
+   * @param streamName stream name as the receiver gets it, e.g. ndn--org--md2k--mguard--dd40c--phone--gps
+   * @param metaData header of the batch
+   * @param mode BLOCKING backs off until there is room, it must not be used on the io thread of
+   *  the face (the queue is drained there)
+   * @return false if the queue was full (NON_BLOCKING only)
+  */
+  bool
+  submit(std::string streamName, std::string metaData, std::vector<std::string> rows,
+         SubmitMode mode = SubmitMode::BLOCKING);
+
+  const IngestQueue&
+  getQueue() const
+  {
+    return *m_queue;
+  }
+
+private:
+  std::shared_ptr<IngestQueue> m_queue;
+};
+
+} // mguard
+
+#endif // MGUARD_PUBLISHER_HANDLE_HPP
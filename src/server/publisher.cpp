@@ -19,6 +19,7 @@
 
 #include "publisher.hpp"
 #include "../common.hpp"
+#include "../manifest.hpp"
 
 #include <boost/bind.hpp>
 
@@ -26,6 +27,28 @@ NDN_LOG_INIT(mguard.Publisher);
 
 namespace mguard {
 
+const std::string STARTUP_REPO = "repo connection";
+const std::string STARTUP_AA = "attribute authority public parameters";
+const std::string STARTUP_PREFIX = "producer prefix registration";
+
+// throw-away encryption telling whether the producer has the public parameters
+const ndn::Name PARAMS_PROBE_NAME("/mguard/PARAMS-PROBE");
+const std::vector<std::string> PARAMS_PROBE_ATTRIBUTES{"mguard-params-probe"};
+const uint8_t PARAMS_PROBE_CONTENT[] = {0};
+
+static std::vector<std::string>
+getNativeRepoShardPaths()
+{
+  if (NATIVE_REPO_SHARDS <= 1)
+    return {NATIVE_REPO_PATH};
+
+  std::vector<std::string> paths;
+  for (size_t i = 0; i < NATIVE_REPO_SHARDS; ++i) {
+    paths.push_back(NATIVE_REPO_PATH + "/shard-" + std::to_string(i));
+  }
+  return paths;
+}
+
 Publisher::Publisher(ndn::Face& face, ndn::security::KeyChain& keyChain,
                     const ndn::Name& producerPrefix,
                     const ndn::security::Certificate& producerCert,
@@ -34,66 +57,350 @@ Publisher::Publisher(ndn::Face& face, ndn::security::KeyChain& keyChain,
 : m_face(face)
 , m_keyChain(keyChain)
 , m_scheduler(m_face.getIoService())
+, m_startupBarrier(m_scheduler, {STARTUP_REPO, STARTUP_AA, STARTUP_PREFIX})
+, m_flushTimers(m_scheduler, MANIFEST_FLUSH_TICK, std::bind(&Publisher::onFlushDeadlines, this, _1))
+, m_contentCache(m_scheduler, CONTENT_CACHE_CAPACITY, CONTENT_CACHE_TTL, CONTENT_CACHE_STORED_GRACE)
 /*
-  40 = expected number of entries also will be used as IBF size
-  syncPrefix = <producer-prefix> /ndn/org/md2k/, userPrefix = /ndn/org/md2k/mguard....
   we are using producer's prefix as sync prefix, may need to change this in the future
+  the streams are synced in groups under it, see getSyncGroupPrefix
 */
-, m_partialProducer(m_face, m_keyChain, 40, producerPrefix,
-                    "/ndn/org/md2k/mguard/dd40c/data_analysis/gps_episodes_and_semantic_location/MANIFEST")
-, m_asyncRepoInserter(m_face.getIoService())
+, m_syncGroups(m_face, m_keyChain, producerPrefix, SYNC_COALESCE_WINDOW)
+, m_nativeRepo(USE_NATIVE_REPO ? std::make_unique<repo::NativeRepo>(m_face, getNativeRepoShardPaths(),
+                                                                        REPO_SEGMENT_SIZE, REPO_SYNC_INTERVAL)
+                                : nullptr)
+, m_asyncRepoInserter(m_face.getIoService(), m_nativeRepo.get(), REPO_CONNECTION_POOL_SIZE)
+, m_onWritten([this] (const auto& name, const auto& err) { writeHandler(name, err); })
+, m_segmentBuffers(SEGMENT_BUFFER_POOL_SIZE)
+, m_attrAuthorityPrefix(ndn::security::extractIdentityFromCertName(attrAuthorityCertificate.getName()))
 , m_producerPrefix(producerPrefix)
 , m_producerCert(producerCert)
 , m_authorityCert(attrAuthorityCertificate)
 , m_abe_producer(m_face, m_keyChain, m_validator, m_producerCert, m_authorityCert)
+, m_precomputePool(m_scheduler, m_abe_producer, PRECOMPUTE_IDLE_TIME)
+, m_catalogPrefix(ndn::Name(producerPrefix).append(STREAM_CATALOG_COMPONENT))
+, m_catalogNotifyPrefix(ndn::Name(m_catalogPrefix).append(CATALOG_NOTIFY_COMPONENT))
+, m_checkpoint(m_face.getIoService(), PRODUCER_CHECKPOINT_PATH, [this] { return makeCheckpoint(); })
 {
   m_validator.load("certs/trust-schema.conf");
+  // consumers see the sequence numbers as soon as the sync update is out, they must not be
+  // reused after a restart
+  m_syncGroups.setBeforeUpdateCallback([this] { m_checkpoint.flush(); });
   auto certName = ndn::security::extractIdentityFromCertName(m_producerCert.getName());
+  setupManifestSigningKey();
 
   NDN_LOG_INFO("Setting interest filter on name: " << certName);
   m_certServeHandle = m_face.setInterestFilter(ndn::InterestFilter(certName).allowLoopback(false),
-                        [this] (auto&&...) {
-                          m_face.put(this->m_producerCert);
+                        [this] (const auto&, const auto& interest) {
+                          onInterest(interest);
                         },
                         std::bind(&Publisher::onRegistrationSuccess, this, _1),
                         std::bind(&Publisher::onRegistrationFailed, this, _1));
 
-  m_asyncRepoInserter.AsyncConnectToRepo(std::bind(&Publisher::connectHandler, this, _1));
-  std::this_thread::sleep_for (std::chrono::seconds(1));
   NDN_LOG_DEBUG("Connecting to repo...");
+  m_asyncRepoInserter.AsyncConnectToRepo(std::bind(&Publisher::connectHandler, this, _1));
+  checkAttributeAuthority();
 
-  if (streamsToPublish.empty()) {
-    NDN_LOG_DEBUG("Streams to publish (streamsToPublish) cannot be empty");
-    NDN_THROW(Error("Streams to publish (streamsToPublish) cannot be empty"));
-  }
-
-  // --------------- in duscussion, only for testing----------
-  // Discussion: we will add all the possible stream to the psync at the begnning.
-  // This is for the current testing and experiment only, the design needs to be better
-  // reason: consumer kicks in, finds that the stream is still not available (sequential processing)
-  // of the stream during the experiment, and thus keeps sending hello interest (causes a lot of overhead)
-  // second, if we send hello interest less frequently, the overall data retrival delay increases.
-  
+  // consumers learn the streams from the catalog, a stream only joins the sync once it publishes
   for (auto& name: streamsToPublish)
-    m_partialProducer.addUserNode(name);
+    registerStream(name);
+
+  m_flushTimers.reserve(streamsToPublish.size());
+  restoreCheckpoint();
+  // published even without streams, consumers then know the producer has none yet
+  scheduleCatalogUpdate();
 
   // if we want to start sync with specific sequence number, we can do the following
   // m_partialProducer.updateSeqNo(<preifx>, <seq-num>);
+}
+
+void
+Publisher::checkAttributeAuthority()
+{
+  // public parameters name of NAC-ABE, /<aa-prefix>/PUBPARAMS
+  ndn::Interest interest(ndn::Name(m_attrAuthorityPrefix).append("PUBPARAMS"));
+  interest.setCanBePrefix(true);
+  interest.setMustBeFresh(true);
+
+  auto retry = [this] (const std::string& reason) {
+    if (m_startupBarrier.hasFailed())
+      return;
+    NDN_LOG_DEBUG("Attribute authority didn't answer (" << reason << "), retrying");
+    m_scheduler.schedule(PUBLIC_PARAMS_RETRY_INTERVAL, [this] { checkAttributeAuthority(); });
+  };
+
+  m_face.expressInterest(interest,
+    [this] (const auto&, const auto& data) {
+      NDN_LOG_INFO("Attribute authority is up: " << data.getName());
+      checkProducerParams();
+    },
+    [retry] (const auto&, const auto&) { retry("nack"); },
+    [retry] (const auto&) { retry("timeout"); });
+}
+
+void
+Publisher::checkProducerParams()
+{
+  if (m_startupBarrier.hasFailed())
+    return;
+
+  // without the public parameters produce() gives no packets (or throws)
+  std::shared_ptr<ndn::Data> data, ckData;
+  try {
+    std::tie(data, ckData) = m_abe_producer.produce(PARAMS_PROBE_NAME, PARAMS_PROBE_ATTRIBUTES,
+                                                    {PARAMS_PROBE_CONTENT, sizeof(PARAMS_PROBE_CONTENT)},
+                                                    ndn::security::signingWithSha256());
+  }
+  catch (const std::exception& e) {
+    NDN_LOG_DEBUG("Producer can't encrypt yet: " << e.what());
+  }
+
+  if (data && ckData) {
+    NDN_LOG_INFO("Producer has the public parameters of the attribute authority");
+    m_startupBarrier.satisfy(STARTUP_AA);
+    return;
+  }
+  NDN_LOG_DEBUG("Producer doesn't have the public parameters yet, checking again");
+  m_scheduler.schedule(PUBLIC_PARAMS_RETRY_INTERVAL, [this] { checkProducerParams(); });
+}
+
+void
+Publisher::restoreCheckpoint()
+{
+  for (auto& state : m_checkpoint.load()) {
+    auto& stream = getOrCreateStream(state.streamName);
+    NDN_LOG_INFO("Restoring stream: " << state.streamName << " manifest seq: " << state.manifestSeq
+                 << " index seq: " << state.indexSeq << " pending entries: " << state.pendingEntries.size());
+
+    // consumers have seen these sequence numbers, continue after them
+    if (state.manifestSeq > 0) {
+      m_syncGroups.addPrefix(stream.getName(), stream.getManifestName());
+      m_syncGroups.publishName(stream.getManifestName(), state.manifestSeq);
+    }
+    if (state.indexSeq > 0) {
+      m_syncGroups.addPrefix(stream.getName(), stream.getIndexName());
+      m_syncGroups.publishName(stream.getIndexName(), state.indexSeq);
+    }
+
+    stream.setOpenIndex(state.openIndex);
+    if (state.lastPublished)
+      stream.setLastPublished(*state.lastPublished);
+
+    for (const auto& entry : state.pendingEntries) {
+      stream.updateManifestList(entry);
+    }
+    if (!state.pendingEntries.empty())
+      scheduledManifestForPublication(stream);
+  }
+}
+
+void
+Publisher::registerStream(const ndn::Name& streamName)
+{
+  if (!m_catalog.streams.insert(streamName).second)
+    return;
+
+  NDN_LOG_INFO("Adding stream: " << streamName << " to the catalog");
+  scheduleCatalogUpdate();
+}
+
+void
+Publisher::scheduleCatalogUpdate()
+{
+  if (m_isCatalogUpdateScheduled)
+    return;
+  m_isCatalogUpdateScheduled = true;
+  m_catalogPendingSince = ndn::time::system_clock::now();
+  m_scheduler.schedule(CATALOG_UPDATE_DELAY, [this] { publishCatalog(); });
+}
+
+void
+Publisher::publishCatalog()
+{
+  m_isCatalogUpdateScheduled = false;
+  // versions keep increasing across restarts, consumers compare them with what they fetched last.
+  // The version is the time the first new stream showed up, consumers measure the latency from it
+  auto since = static_cast<uint64_t>(ndn::time::toUnixTimestamp(m_catalogPendingSince).count());
+  m_catalog.version = std::max(m_catalog.version + 1, since);
+
+  auto versionedName = m_catalogPrefix;
+  versionedName.appendNumber(m_catalog.version);
+  NDN_LOG_INFO("Publishing stream catalog: " << versionedName << " streams: " << m_catalog.streams.size());
+  try {
+    storeSegmented(versionedName, m_catalog.wireEncode(), m_catalogPrefix);
+  }
+  catch (const std::exception& e) {
+    NDN_LOG_ERROR("Failed to insert the stream catalog into the repo: " << e.what());
+    return;
+  }
+  m_syncGroups.announce(m_catalogPrefix, m_catalog.version);
+  satisfyCatalogNotifies();
+}
+
+void
+Publisher::onCatalogNotify(const ndn::Interest& interest)
+{
+  // /<producer-prefix>/CATALOG/NOTIFY/<known-version>
+  uint64_t knownVersion = 0;
+  const auto& name = interest.getName();
+  if (name.size() > m_catalogNotifyPrefix.size() && name.get(m_catalogNotifyPrefix.size()).isNumber())
+    knownVersion = name.get(m_catalogNotifyPrefix.size()).toNumber();
+
+  if (m_catalog.version > knownVersion) {
+    m_catalogNotifies.emplace_front(interest, ndn::time::steady_clock::time_point::max());
+    satisfyCatalogNotifies();
+    return;
+  }
+
+  NDN_LOG_TRACE("Keeping catalog notification pending: " << name);
+  m_catalogNotifies.emplace_back(interest, ndn::time::steady_clock::now() + interest.getInterestLifetime());
+  if (m_catalogNotifies.size() > CATALOG_NOTIFY_MAX_PENDING)
+    m_catalogNotifies.pop_front();
+}
+
+void
+Publisher::satisfyCatalogNotifies()
+{
+  auto now = ndn::time::steady_clock::now();
+  for (auto it = m_catalogNotifies.begin(); it != m_catalogNotifies.end();) {
+    const auto& [interest, expiry] = *it;
+    const auto& name = interest.getName();
+    bool isOutdated = name.size() <= m_catalogNotifyPrefix.size() ||
+                      !name.get(m_catalogNotifyPrefix.size()).isNumber() ||
+                      name.get(m_catalogNotifyPrefix.size()).toNumber() < m_catalog.version;
+    if (expiry < now) {
+      it = m_catalogNotifies.erase(it);
+      continue;
+    }
+    if (!isOutdated) {
+      ++it;
+      continue;
+    }
+
+    // only a hint to fetch the (signed) catalog, a digest signature is enough
+    ndn::Data data(name);
+    data.setContent(ndn::encoding::makeNonNegativeIntegerBlock(ndn::tlv::Content, m_catalog.version));
+    data.setFreshnessPeriod(CATALOG_UPDATE_DELAY);
+    m_keyChain.sign(data, ndn::security::signingWithSha256());
+    m_face.put(data);
+    it = m_catalogNotifies.erase(it);
+  }
+}
+
+void
+Publisher::storeSegmented(const ndn::Name& versionedName, const ndn::Block& content,
+                          const ndn::Name& streamName)
+{
+  size_t nSegments = std::max<size_t>(1, (content.size() + MANIFEST_SEGMENT_SIZE - 1) / MANIFEST_SEGMENT_SIZE);
+  auto finalBlockId = ndn::name::Component::fromSegment(nSegments - 1);
+
+  for (size_t segmentNo = 0; segmentNo < nSegments; ++segmentNo) {
+    auto segmentName = versionedName;
+    segmentName.appendSegment(segmentNo);
+    auto data = std::make_shared<ndn::Data>(segmentName);
+
+    auto begin = content.wire() + segmentNo * MANIFEST_SEGMENT_SIZE;
+    auto end = content.wire() + std::min(content.size(), (segmentNo + 1) * MANIFEST_SEGMENT_SIZE);
+    // only referenced until the segment is signed, the buffer is then free for the next one
+    data->setContent(m_segmentBuffers.acquire(begin, end));
+    data->setFinalBlock(finalBlockId);
+    m_keyChain.sign(*data, m_manifestSigningInfo);
+
+    NDN_LOG_INFO("start repo insertion for name: " << data->getName());
+    storeData(std::move(data), streamName);
+  }
+}
+
+std::vector<util::StreamCheckpoint>
+Publisher::makeCheckpoint()
+{
+  std::vector<util::StreamCheckpoint> streams;
+  for (auto& [name, stream] : m_streams) {
+    util::StreamCheckpoint state;
+    state.streamName = name;
+    state.manifestSeq = m_syncGroups.getSeqNo(stream.getManifestName()).value_or(0);
+    state.indexSeq = m_syncGroups.getSeqNo(stream.getIndexName()).value_or(0);
+    state.lastPublished = stream.getLastPublished();
+    state.openIndex = stream.getOpenIndex();
+    state.pendingEntries = stream.getManifestList();
+    streams.push_back(std::move(state));
+  }
+  return streams;
+}
 
-  // sleep to init kp-abe producer
-  std::this_thread::sleep_for (std::chrono::seconds(1));
+void
+Publisher::setupManifestSigningKey()
+{
+  switch (MANIFEST_SIGNER) {
+    case ManifestSigner::PRODUCER:
+      m_manifestSigningInfo = ndn::security::signingByCertificate(m_producerCert);
+      break;
+
+    case ManifestSigner::HMAC:
+      NDN_LOG_INFO("Manifests will be signed with the HMAC key from: " << MANIFEST_HMAC_KEY_PATH);
+      m_manifestSigningInfo.setSigningHmacKey(loadHmacKey(MANIFEST_HMAC_KEY_PATH));
+      break;
+
+    case ManifestSigner::ECDSA: {
+      m_manifestCert = manifest::getManifestCertificate(m_keyChain, m_producerCert);
+      NDN_LOG_INFO("Manifests will be signed with: " << m_manifestCert->getName());
+      m_manifestSigningInfo = ndn::security::signingByCertificate(*m_manifestCert);
+      break;
+    }
+  }
+}
+
+void
+Publisher::onInterest(const ndn::Interest& interest)
+{
+  if (m_catalogNotifyPrefix.isPrefixOf(interest.getName())) {
+    onCatalogNotify(interest);
+    return;
+  }
+
+  // stream prefixes are under the producer identity, fresh packets are answered before the repo has them
+  if (auto data = m_contentCache.find(interest)) {
+    NDN_LOG_TRACE("Serving from content cache: " << data->getName());
+    m_face.put(*data);
+    return;
+  }
+
+  if (m_nativeRepo) {
+    try {
+      if (auto data = m_nativeRepo->find(interest)) {
+        m_face.put(*data);
+        return;
+      }
+    }
+    catch (const std::exception& e) {
+      NDN_LOG_ERROR("Failed to read from repo: " << interest.getName() << " " << e.what());
+    }
+  }
+
+  if (m_manifestCert && interest.getName().isPrefixOf(m_manifestCert->getName())) {
+    NDN_LOG_DEBUG("Serving manifest signing certificate: " << m_manifestCert->getName());
+    m_face.put(*m_manifestCert);
+    return;
+  }
+  if (interest.getName().isPrefixOf(m_producerCert.getName())) {
+    m_face.put(m_producerCert);
+    return;
+  }
+  // anything else is left to the repo, answering with the certificate would shadow its data
+  NDN_LOG_TRACE("Not answering: " << interest.getName());
 }
 
 void
 Publisher::onRegistrationSuccess(const ndn::Name& name)
 {
   NDN_LOG_INFO("Successfully registered prefix: " << name);
+  m_startupBarrier.satisfy(STARTUP_PREFIX);
 }
 
 void
 Publisher::onRegistrationFailed(const ndn::Name& name)
 {
   NDN_LOG_INFO("ERROR: Failed to register prefix " << name << " in local hub's daemon");
+  m_startupBarrier.fail(STARTUP_PREFIX, "failed to register " + name.toUri());
 }
 
 void
@@ -102,68 +409,121 @@ Publisher::connectHandler(const mguard::util::AsyncRepoError& err)
   if (!err)
     NDN_LOG_DEBUG("Connection successful");
   else
-    NDN_LOG_DEBUG("Connection failled");
+    NDN_LOG_WARN("Connection failled, packets are spilled while retrying in the background: " << err.message());
+  // not fatal, the repo connection doesn't hold up ingest
+  m_startupBarrier.satisfy(STARTUP_REPO);
 }
 
 void
-Publisher::writeHandler(const ndn::Data& data, const mguard::util::AsyncRepoError& err)
+Publisher::writeHandler(const ndn::Name& name, const mguard::util::AsyncRepoError& err)
 {
-  if (!err)
-    NDN_LOG_DEBUG(data.getName() << " inserted into the repo");
+  if (!err) {
+    NDN_LOG_DEBUG(name << " inserted into the repo");
+    m_contentCache.markStored(name);
+  }
+  else if (err == boost::system::errc::resource_unavailable_try_again)
+    NDN_LOG_DEBUG(name << " spilled to the journal, will be replayed once the repo is back");
+  else
+    NDN_LOG_DEBUG("failed to insert: " << name);
+}
+
+void
+Publisher::setRetentionPolicy(const repo::RetentionPolicy& policy)
+{
+  if (policy.empty())
+    return;
+
+  if (m_nativeRepo)
+    m_nativeRepo->setRetentionPolicy(policy);
   else
-    NDN_LOG_DEBUG("failed to insert: " << data.getName());
+    NDN_LOG_WARN("Retention is only applied by the in-process repo, set the TTLs of the external repo on its own");
+}
+
+void
+Publisher::storeData(std::shared_ptr<const ndn::Data> data, const ndn::Name& streamName)
+{
+  // the repo write shares the wire encoding of the cached packet
+  m_asyncRepoInserter.AsyncWriteDataToRepo(*data, m_onWritten, streamName);
+  m_contentCache.insert(std::move(data));
 }
 
 void
 Publisher::doUpdate(ndn::Name namePrefix, uint64_t currSeqNum)
 {
-  m_partialProducer.publishName(namePrefix, currSeqNum+1);
-  auto seqNo =  m_partialProducer.getSeqNo(namePrefix).value();
-  std::cout << "sequence number: " << seqNo << std::endl;
+  m_syncGroups.publishName(namePrefix, currSeqNum+1);
+  auto seqNo =  m_syncGroups.getSeqNo(namePrefix).value();
   NDN_LOG_DEBUG("Publish sync update for the name/manifest: " << namePrefix << " sequence Number: " << seqNo);
+  if (USE_MANIFEST)
+    m_checkpoint.saveLater();
 }
 
 mguard::util::Stream&
 Publisher::getOrCreateStream(ndn::Name& streamName)
 {
-  auto itr = m_streams.find(streamName);
-  if (itr != m_streams.end()) // already exist
-    return itr->second;
+  return getOrCreateStream(m_names.intern(streamName));
+}
 
+mguard::util::Stream&
+Publisher::getOrCreateStream(util::InternedId streamId)
+{
+  if (streamId < m_streamsById.size() && m_streamsById[streamId] != nullptr) // already exist
+    return *m_streamsById[streamId];
+
+  const auto& streamName = m_names.getName(streamId);
   auto [it, success] = m_streams.emplace(streamName, streamName);
+  it->second.setIndex(m_streamsByIndex.size());
+  m_streamsByIndex.push_back(&it->second);
+  if (streamId >= m_streamsById.size())
+    m_streamsById.resize(streamId + 1, nullptr);
+  m_streamsById[streamId] = &it->second;
+  registerStream(streamName);
   return it->second;
 }
 
+const std::vector<std::string>&
+Publisher::getAttributeList(const std::vector<util::InternedId>& attributes)
+{
+  auto it = m_attributeLists.find(attributes);
+  if (it != m_attributeLists.end())
+    return it->second;
+
+  std::vector<std::string> attrList;
+  attrList.reserve(attributes.size());
+  for (auto id : attributes) {
+    attrList.push_back(m_names.getUri(id));
+  }
+  return m_attributeLists.emplace(attributes, std::move(attrList)).first->second;
+}
+
 void
 Publisher::scheduledManifestForPublication(util::Stream& stream)
 {
-  auto& manifestName = stream.getManifestName();
-  auto itr = m_scheduledIds.find(manifestName);
-  NDN_LOG_DEBUG("Scheduling manifest: " << manifestName << " for publication");
-  
-  if (itr != m_scheduledIds.end()) {
-    NDN_LOG_DEBUG("Manifest: " << manifestName << " was already scheduled, updating the schedule");
-    itr->second.cancel();
-    auto scheduleId = m_scheduler.schedule(MAX_UPDATE_WAIT_TIME, [&] {
-                      doUpdate(manifestName, publishManifest(stream));
-                      NDN_LOG_DEBUG("Updated manifest: " << manifestName << " via scheduling");
-                    });
-    itr->second = scheduleId;
-  }
-  else {
-    auto scheduleId = m_scheduler.schedule(MAX_UPDATE_WAIT_TIME, [&] {
-                      doUpdate(manifestName, publishManifest(stream));
-                      NDN_LOG_DEBUG("Updated manifest: " << manifestName << " via scheduling");
-                    });
-    m_scheduledIds.emplace(manifestName, scheduleId);
-  }
+  auto flushDelay = stream.getFlushDelay();
+  NDN_LOG_DEBUG("Scheduling manifest: " << stream.getManifestName() << " for publication in " << flushDelay);
+  // moves the deadline if the manifest was already scheduled
+  m_flushTimers.schedule(stream.getIndex(), flushDelay);
 }
 
 void
-Publisher::publish(ndn::Name& dataName, std::string data, 
-                   std::vector<std::string> attrList,
-                   ndn::Name& streamName)
+Publisher::onFlushDeadlines(const std::vector<size_t>& expired)
 {
+  for (auto index : expired) {
+    auto& stream = *m_streamsByIndex[index];
+    if (stream.getManifestList().empty())
+      continue;
+
+    doUpdate(stream.getManifestName(), publishManifest(stream));
+    NDN_LOG_DEBUG("Updated manifest: " << stream.getManifestName() << " via scheduling");
+  }
+}
+
+bool
+Publisher::publish(ndn::Name& dataName, const std::string& data,
+                   const std::vector<util::InternedId>& attributes,
+                   util::InternedId streamId)
+{
+  const auto& streamName = m_names.getName(streamId);
+  const auto& attrList = getAttributeList(attributes);
   NDN_LOG_DEBUG("Publishing data name: " << dataName << " data: " << data << " and size: " << data.size());
 
   std::shared_ptr<ndn::Data> enc_data, ckData;
@@ -173,6 +533,10 @@ Publisher::publish(ndn::Name& dataName, std::string data,
     // TODO::: we should handle this in a better way
     auto dataSufix = dataName.getSubName(3);
     NDN_LOG_TRACE("--------- data suffix: " << dataSufix);
+    if (!m_precomputePool.recordUse(attrList)) {
+      NDN_LOG_DEBUG("Content key for the attributes was not precomputed, pool hit rate: "
+                    << m_precomputePool.getHitRate());
+    }
     std::tie(enc_data, ckData) = m_abe_producer.produce(dataSufix, attrList,
                                     {reinterpret_cast<const uint8_t *>(data.c_str()), data.size()},
                                     ndn::security::signingWithSha256()
@@ -181,19 +545,27 @@ Publisher::publish(ndn::Name& dataName, std::string data,
   catch(const std::exception& e) {
     NDN_LOG_ERROR("Encryption for the data: " << dataName << " failled");
     std::cerr << e.what() << '\n';
-    return;  // need to throw from here?
+    return false;  // need to throw from here?
+  }
+
+  if (!enc_data || !ckData) {
+    // the producer has no public parameters (anymore)
+    NDN_LOG_ERROR("Encryption for the data: " << dataName << " gave no packets, dropping it");
+    return false;
   }
 
   //  encrypted data is created, store it in the buffer and publish it
-  NDN_LOG_INFO("full name of the data: " << enc_data->getFullName() << " and size: " << enc_data->getContent().size());
+  // the full name is computed once and cached by the packet, the manifest entry is a copy of it
+  const auto& fullName = enc_data->getFullName();
+  NDN_LOG_INFO("full name of the data: " << fullName << " and size: " << enc_data->getContent().size());
   NDN_LOG_INFO("full name of the ckData: " << ckData->getFullName() << " and size: " << ckData->getContent().size());
 
   try {
     NDN_LOG_INFO("start repo insertion for name: " << enc_data->getName());
 
     // insert data and CK data into repo
-    m_asyncRepoInserter.AsyncWriteDataToRepo(*ckData, std::bind(&Publisher::writeHandler, this, _1, _2));
-    m_asyncRepoInserter.AsyncWriteDataToRepo(*enc_data, std::bind(&Publisher::writeHandler, this, _1, _2));
+    storeData(ckData, streamName);
+    storeData(enc_data, streamName);
   }
   catch(const std::exception& e) {
       NDN_LOG_ERROR("data and cKdata insertion failed");
@@ -201,66 +573,107 @@ Publisher::publish(ndn::Name& dataName, std::string data,
   }
 
   if (!USE_MANIFEST) {
+    registerStream(streamName);
     // if manifest is not used, the dataName is directly published in the sync
-    m_partialProducer.addUserNode(dataName);
-    uint64_t currSeqNum =  m_partialProducer.getSeqNo(dataName).value();
+    m_syncGroups.addPrefix(streamName, dataName);
+    uint64_t currSeqNum =  m_syncGroups.getSeqNo(dataName).value();
     doUpdate(dataName, currSeqNum);
-    return;
+    return true;
   }
 
-  auto& stream = getOrCreateStream(streamName);
+  auto& stream = getOrCreateStream(streamId);
 
   NDN_LOG_DEBUG("Manifest name: " << stream.getManifestName());
 
-  bool doPublishManifest = stream.updateManifestList(enc_data->getFullName());
+  bool doPublishManifest = stream.updateManifestList(fullName);
+  m_checkpoint.saveLater();
   // manifest are publihsed to sync after receiving X (e.g. 10) number of application data or if
   // "t" time has passed after receiving the last application data.
   if (!doPublishManifest) {
     scheduledManifestForPublication(stream);
-    return;
+    return true;
   }
-  cancleIfManifestScheduledForPublication(stream.getName());
+  cancleIfManifestScheduledForPublication(stream);
   // create manifest data packet, and insert it into the repo
   doUpdate(stream.getManifestName(), publishManifest(stream));
+  return true;
 }
 
 uint64_t
 Publisher::publishManifest(util::Stream& stream)
 {
   auto dataName = stream.getManifestName();
-  m_partialProducer.addUserNode(dataName);
+  m_syncGroups.addPrefix(stream.getName(), dataName);
 
-  uint64_t currSeqNum =  m_partialProducer.getSeqNo(dataName).value();
+  uint64_t currSeqNum =  m_syncGroups.getSeqNo(dataName).value();
 
   /* For testing, randomizing sequence number
   if (currSeqNum == 0)
     currSeqNum = rand() % 1000;
   */
   dataName.appendNumber(currSeqNum + 1);
-  auto manifestData = std::make_shared<ndn::Data>(dataName);
-  
-  m_temp = stream.getManifestList();
-  manifestData->setContent(wireEncode());
-  NDN_LOG_DEBUG ("Manifest name: " << dataName << " manifest data size: " << manifestData->getContent().size()
+
+  // encoded straight from the list of the stream, no copy
+  m_temp = &stream.getManifestList();
+  const auto& content = wireEncode();
+
+  // large batches (or long names) don't fit into one packet, manifest is published in segments
+  // under a versioned name
+  auto versionedName = dataName;
+  versionedName.appendVersion();
+
+  NDN_LOG_DEBUG ("Manifest name: " << versionedName << " manifest data size: " << content.size()
                  << " and seqNumber: " << currSeqNum + 1);
-  
-  m_keyChain.sign(*manifestData, ndn::security::signingByCertificate(m_producerCert));
 
   try {
-      NDN_LOG_INFO("start repo insertion for name: " << manifestData->getName());
-      m_asyncRepoInserter.AsyncWriteDataToRepo(*manifestData, std::bind(&Publisher::writeHandler, this, _1, _2));
+    storeSegmented(versionedName, content, stream.getName());
 
-      m_temp.clear(); // clear temp variable
-      stream.resetManifestList(); // clear manifest list
-      m_wire.reset(); // reset the wire for new content
+    m_temp = nullptr;
+    stream.resetManifestList(); // clear manifest list
+    stream.setLastPublished(ndn::time::system_clock::now());
+    m_wire.reset(); // reset the wire for new content
   }
   catch(const std::exception& e) {
     NDN_LOG_ERROR("Failed to insert mainfest into the repo");
     std::cerr << e.what() << '\n';
   }
+
+  updateManifestIndex(stream, currSeqNum + 1);
   return currSeqNum; // this is next sequence number
 }
 
+void
+Publisher::updateManifestIndex(util::Stream& stream, uint64_t manifestSeq)
+{
+  auto completeIndex = stream.updateIndex(manifestSeq, ndn::time::system_clock::now());
+  if (!completeIndex)
+    return;
+
+  const auto& indexPrefix = stream.getIndexName();
+  m_syncGroups.addPrefix(stream.getName(), indexPrefix);
+  uint64_t indexSeq = m_syncGroups.getSeqNo(indexPrefix).value() + 1;
+
+  auto indexName = indexPrefix;
+  indexName.appendNumber(indexSeq);
+  auto indexData = std::make_shared<ndn::Data>(indexName);
+  indexData->setContent(completeIndex->wireEncode());
+  m_keyChain.sign(*indexData, m_manifestSigningInfo);
+
+  NDN_LOG_DEBUG("Index name: " << indexName << " manifests: " << completeIndex->firstSeq
+                << " - " << completeIndex->lastSeq);
+  try {
+    storeData(indexData, stream.getName());
+  }
+  catch(const std::exception& e) {
+    NDN_LOG_ERROR("Failed to insert manifest index into the repo");
+    std::cerr << e.what() << '\n';
+    return;
+  }
+  // the latest index sequence number reaches consumers with the hello data
+  m_syncGroups.publishName(indexPrefix, indexSeq);
+  m_checkpoint.saveLater();
+}
+
 const ndn::Block&
 Publisher::wireEncode() const
 {
@@ -284,9 +697,19 @@ Publisher::wireEncode(ndn::EncodingImpl<TAG> &encoder) const
 {
   size_t totalLength = 0;
   
-  for (auto it = m_temp.rbegin(); it != m_temp.rend(); ++it) {
-    NDN_LOG_DEBUG ("Encoding data name: " << *it);
-    totalLength += it->wireEncode(encoder);
+  if (USE_COMPACT_MANIFEST) {
+    auto prefix = manifest::getCommonPrefix(*m_temp);
+    for (auto it = m_temp->rbegin(); it != m_temp->rend(); ++it) {
+      NDN_LOG_DEBUG ("Encoding data name: " << *it);
+      totalLength += manifest::prependComponents(encoder, mguard::tlv::mGuardManifestEntry, *it, prefix.size());
+    }
+    totalLength += manifest::prependComponents(encoder, mguard::tlv::mGuardManifestPrefix, prefix);
+  }
+  else {
+    for (auto it = m_temp->rbegin(); it != m_temp->rend(); ++it) {
+      NDN_LOG_DEBUG ("Encoding data name: " << *it);
+      totalLength += it->wireEncode(encoder);
+    }
   }
 
   totalLength += encoder.prependVarNumber(totalLength);
@@ -23,8 +23,16 @@
 #include "file-processor.hpp"
 #include "util/stream.hpp"
 #include "util/async-repo-inserter.hpp"
+#include "util/abe-precompute-pool.hpp"
+#include "util/timer-wheel.hpp"
+#include "util/content-cache.hpp"
+#include "util/checkpoint.hpp"
+#include "util/startup-barrier.hpp"
+#include "util/sync-groups.hpp"
+#include "util/name-interner.hpp"
+#include "util/buffer-pool.hpp"
+#include "repo/native-repo.hpp"
 
-#include <PSync/partial-producer.hpp>
 #include <nac-abe/attribute-authority.hpp>
 #include <nac-abe/cache-producer.hpp>
 
@@ -36,6 +44,8 @@
 #include <boost/asio/ip/tcp.hpp>
 
 #include <unordered_map>
+#include <list>
+#include <optional>
 #include <iostream>
 #include <string>
 #include <chrono>
@@ -52,9 +62,30 @@ public:
             const ndn::security::Certificate& attrAuthorityCertificate,
             const std::vector<std::string>& streamsToPublish);
   
+  /**
+   * @brief Call onReady once the publisher can take data: the repo connection is attempted
+   *  (packets are spilled until it is up), the attribute authority answered with its public
+   *  parameters and the producer prefix is registered. onFailure gets the reason if a step
+   *  fails or doesn't complete within the timeout.
+  */
+  void
+  whenReady(const util::ReadyCallback& onReady, const util::StartupFailureCallback& onFailure,
+            ndn::time::milliseconds timeout = STARTUP_TIMEOUT)
+  {
+    m_startupBarrier.wait(onReady, onFailure, timeout);
+  }
+
   void
   onRegistrationSuccess(const ndn::Name& name);
 
+  /**
+   * @brief Serve freshly produced packets (data, CK, manifest) from the content cache,
+   *  or from the in-process repo if it is used, otherwise producer's certificate, or the
+   *  manifest signing certificate if the interest is for that one
+  */
+  void
+  onInterest(const ndn::Interest& interest);
+
   void
   onRegistrationFailed(const ndn::Name& name);
 
@@ -63,7 +94,7 @@ public:
   connectHandler(const mguard::util::AsyncRepoError& err);
   
   void 
-  writeHandler(const ndn::Data& data, const mguard::util::AsyncRepoError& err);
+  writeHandler(const ndn::Name& name, const mguard::util::AsyncRepoError& err);
 
   void
   doUpdate(ndn::Name namePrefix, uint64_t currSeqNum);
@@ -75,27 +106,86 @@ public:
     m_dataBuffer.clear();
   }
 
-  void
-  publish(ndn::Name& dataName, std::string data, std::vector<std::string> attrList,
-          ndn::Name& streamName);
+  /**
+   * @param attributes interned attribute names to encrypt with, see getNameInterner()
+   * @param streamId interned stream name
+   * @return false if the data couldn't be encrypted, nothing is published then
+  */
+  bool
+  publish(ndn::Name& dataName, const std::string& data, const std::vector<util::InternedId>& attributes,
+          util::InternedId streamId);
 
   uint64_t
   publishManifest(util::Stream& stream);
 
+  /**
+   * @brief Record a published manifest in the index of the stream, and publish the index
+   *  object of the previous time bucket (/<stream>/MANIFEST/INDEX/<index-seq>) once it is complete
+   * @param manifestSeq sequence number of the manifest just published
+  */
+  void
+  updateManifestIndex(util::Stream& stream, uint64_t manifestSeq);
+
+  /**
+   * @brief Get the stream, a stream seen for the first time is added to the stream catalog
+  */
   mguard::util::Stream&
   getOrCreateStream(ndn::Name& streamName);
 
+  mguard::util::Stream&
+  getOrCreateStream(util::InternedId streamId);
+
+  /**
+   * @brief Ids of the stream and attribute names given to publish()
+  */
+  util::NameInterner&
+  getNameInterner()
+  {
+    return m_names;
+  }
+
+  /**
+   * @brief Set the manifest batching policy of a stream, streams use
+   *  BatchingPolicy::makeDefault() otherwise
+  */
+  void
+  setBatchingPolicy(ndn::Name& streamName, const util::BatchingPolicy& policy)
+  {
+    getOrCreateStream(streamName).setBatchingPolicy(policy);
+  }
+
+  /**
+   * @brief Add an attribute set that is expected to be used for encryption, the content
+   *  key for it will be prepared when the publisher is idle
+   * @param attrList attribute list in the same order as passed to publish()
+  */
+  void
+  addExpectedAttributes(const std::vector<std::string>& attrList)
+  {
+    m_precomputePool.addExpectedAttributes(attrList);
+  }
+
+  const util::AbePrecomputePool&
+  getPrecomputePool() const
+  {
+    return m_precomputePool;
+  }
+
   void
   scheduledManifestForPublication(util::Stream& stream);
 
   void
-  cancleIfManifestScheduledForPublication(const ndn::Name& name)
+  cancleIfManifestScheduledForPublication(util::Stream& stream)
   {
-    auto itr = m_scheduledIds.find(name);
-    if (itr != m_scheduledIds.end()) {
-      itr->second.cancel();
-    }
+    m_flushTimers.cancel(stream.getIndex());
   }
+
+  /**
+   * @brief Publish the manifests of the streams whose flush deadline expired
+   * @param expired indexes of the streams
+  */
+  void
+  onFlushDeadlines(const std::vector<size_t>& expired);
   
   template<ndn::encoding::Tag TAG>
   size_t
@@ -103,29 +193,157 @@ public:
 
   const ndn::Block&
   wireEncode() const;
-  
+
+  /**
+   * @brief Expire stored packets according to the policy. Only the in-process repo is handled,
+   *  a standalone mguard-repo takes the TTLs on its command line.
+  */
+  void
+  setRetentionPolicy(const repo::RetentionPolicy& policy);
+
+  const util::ContentCache&
+  getContentCache() const
+  {
+    return m_contentCache;
+  }
+
+  const util::SyncGroups&
+  getSyncGroups() const
+  {
+    return m_syncGroups;
+  }
+
+  const util::AsyncRepoInserter&
+  getRepoInserter() const
+  {
+    return m_asyncRepoInserter;
+  }
+
+private:
+  /**
+   * @brief Keep the packet in the content cache and write it to the repo, the packet is shared
+   *  (not copied) and must not be modified afterwards
+   * @param streamName packets of a stream are written in order through the same repo connection
+  */
+  void
+  storeData(std::shared_ptr<const ndn::Data> data, const ndn::Name& streamName);
+
+  /**
+   * @brief Ask the attribute authority for its public parameters until it answers, the
+   *  CacheProducer fetches (and validates) them on its own, this only tells when the AA is reachable
+  */
+  void
+  checkAttributeAuthority();
+
+  /**
+   * @brief Probe the CacheProducer until it can encrypt, i.e. its own public parameters are
+   *  fetched and validated, only then the attribute authority startup condition is satisfied
+  */
+  void
+  checkProducerParams();
+
+  /**
+   * @brief Continue the sync sequence numbers, pending manifest entries and index buckets
+   *  of the streams from the checkpoint of the last run
+  */
+  void
+  restoreCheckpoint();
+
+  std::vector<util::StreamCheckpoint>
+  makeCheckpoint();
+
+  /**
+   * @brief Add a stream to the catalog, the new version is published after CATALOG_UPDATE_DELAY
+  */
+  void
+  registerStream(const ndn::Name& streamName);
+
+  void
+  scheduleCatalogUpdate();
+
+  /**
+   * @brief Answer a catalog notification interest if its version is outdated, keep it pending otherwise
+  */
+  void
+  onCatalogNotify(const ndn::Interest& interest);
+
+  /**
+   * @brief Answer the pending notification interests with the current catalog version, drop the expired ones
+  */
+  void
+  satisfyCatalogNotifies();
+
+  /**
+   * @brief Store the catalog under <producer-prefix>/CATALOG/<version> and announce the version
+  */
+  void
+  publishCatalog();
+
+  /**
+   * @brief Sign the content in segments of MANIFEST_SEGMENT_SIZE under the versioned name and store them,
+   *  the last segment number is carried as final block id
+  */
+  void
+  storeSegmented(const ndn::Name& versionedName, const ndn::Block& content, const ndn::Name& streamName);
+
+  /**
+   * @brief Prepare signing info for manifests according to MANIFEST_SIGNER
+   *
+   *  For ECDSA, the key is created once under the producer identity and certified by the
+   *  producer key, the certificate is reused on later starts.
+  */
+  void
+  setupManifestSigningKey();
+
+  /**
+   * @brief Attribute list for the encryption, built once per set of attribute ids
+  */
+  const std::vector<std::string>&
+  getAttributeList(const std::vector<util::InternedId>& attributes);
+
 private:
   ndn::Face& m_face;
   ndn::security::KeyChain& m_keyChain;
   ndn::Scheduler m_scheduler;
   ndn::ScopedRegisteredPrefixHandle m_certServeHandle;
+  util::StartupBarrier m_startupBarrier;
 
-  std::map<ndn::Name, ndn::scheduler::ScopedEventId>m_scheduledIds;
+  util::TimerWheel m_flushTimers; // manifest flush deadline of each stream, by stream index
+  util::ContentCache m_contentCache;
   mutable ndn::Block m_wire;
-  psync::PartialProducer m_partialProducer;
+  util::SyncGroups m_syncGroups;
+  std::unique_ptr<repo::NativeRepo> m_nativeRepo; // only if USE_NATIVE_REPO
   util::AsyncRepoInserter m_asyncRepoInserter;
+  util::AsyncWriteHandler m_onWritten; // captures only this, copied into each write without allocating
+  util::BufferPool m_segmentBuffers;
 
-  std::vector<ndn::Name> m_temp;
+  const std::vector<ndn::Name>* m_temp = nullptr; // entries of the manifest being encoded
   ndn::Name m_attrAuthorityPrefix;
   ndn::Name m_producerPrefix;
   ndn::security::Certificate m_producerCert;
   ndn::security::Certificate m_authorityCert;
+  ndn::security::SigningInfo m_manifestSigningInfo;
+  std::optional<ndn::security::Certificate> m_manifestCert;
   ndn::ValidatorConfig m_validator{m_face};
   ndn::nacabe::CacheProducer m_abe_producer;
+  util::AbePrecomputePool m_precomputePool;
 
   std::vector<ndn::Data> m_ckBuffer;
   std::vector<ndn::Data> m_dataBuffer;
+  util::NameInterner m_names;
+  std::map<std::vector<util::InternedId>, std::vector<std::string>> m_attributeLists;
   std::map<ndn::Name, mguard::util::Stream> m_streams;
+  std::vector<mguard::util::Stream*> m_streamsByIndex;
+  std::vector<mguard::util::Stream*> m_streamsById; // by interned stream name, null for other names
+  manifest::StreamCatalog m_catalog;
+  ndn::Name m_catalogPrefix;
+  bool m_isCatalogUpdateScheduled = false;
+  // registration time of the first stream waiting for the next catalog version
+  ndn::time::system_clock::time_point m_catalogPendingSince;
+  ndn::Name m_catalogNotifyPrefix;
+  // pending notification interests with their expiration, oldest first
+  std::list<std::pair<ndn::Interest, ndn::time::steady_clock::time_point>> m_catalogNotifies;
+  util::Checkpoint m_checkpoint;
 };
 
 } // mguard
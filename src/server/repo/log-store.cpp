@@ -0,0 +1,399 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "log-store.hpp"
+#include "../util/record-io.hpp"
+
+#include <ndn-cxx/util/logger.hpp>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/filesystem.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iomanip>
+#include <sstream>
+#include <unistd.h>
+
+namespace mguard {
+namespace repo {
+
+NDN_LOG_INIT(mguard.repo.LogStore);
+
+const uint32_t RECORD_MAGIC = 0x4d47524c; // "MGRL", record carries a data packet
+const uint32_t TOMBSTONE_MAGIC = 0x4d47544d; // "MGTM", record carries the name of an erased packet
+const size_t RECORD_HEADER_SIZE = 20;
+
+static uint64_t
+toMilliseconds(const ndn::time::system_clock::time_point& time)
+{
+  return ndn::time::duration_cast<ndn::time::milliseconds>(time.time_since_epoch()).count();
+}
+
+LogStore::LogStore(const std::string& path, size_t segmentSize)
+: m_path(path)
+, m_segmentSize(segmentSize)
+{
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(m_path, ec);
+  if (ec)
+    NDN_THROW(Error("Cannot create repo directory " + m_path + ": " + ec.message()));
+
+  // compaction removes segments, the numbers have gaps
+  std::set<uint32_t> segments;
+  for (const auto& entry : boost::filesystem::directory_iterator(m_path)) {
+    auto fileName = entry.path().filename().string();
+    if (boost::starts_with(fileName, "segment-") && boost::ends_with(fileName, ".log"))
+      segments.insert(std::stoul(fileName.substr(8, fileName.size() - 12)));
+  }
+
+  for (auto segment : segments) {
+    openSegment(segment);
+    m_segments.at(segment).size = recoverSegment(segment);
+  }
+
+  if (m_segments.empty()) {
+    openSegment(0);
+  }
+  // drop a torn tail of the active segment, appends continue after the last good record
+  else if (::ftruncate(getActiveSegment().fd, getActiveSegment().size) != 0) {
+    NDN_THROW(Error("Failed to truncate " + getSegmentPath(getActiveSegmentNo()) + ": " +
+                    std::strerror(errno)));
+  }
+
+  NDN_LOG_INFO("Opened log store: " << m_path << " packets: " << m_index.size()
+               << " segments: " << m_segments.size());
+}
+
+LogStore::~LogStore()
+{
+  for (const auto& segment : m_segments) {
+    ::fsync(segment.second.fd);
+    ::close(segment.second.fd);
+  }
+}
+
+std::string
+LogStore::getSegmentPath(uint32_t segment) const
+{
+  std::ostringstream os;
+  os << m_path << "/segment-" << std::setw(8) << std::setfill('0') << segment << ".log";
+  return os.str();
+}
+
+void
+LogStore::openSegment(uint32_t segment)
+{
+  auto path = getSegmentPath(segment);
+  int fd = ::open(path.data(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0)
+    NDN_THROW(Error("Failed to open " + path + ": " + std::strerror(errno)));
+
+  m_segments[segment].fd = fd;
+}
+
+void
+LogStore::removeSegment(uint32_t segment)
+{
+  auto it = m_segments.find(segment);
+  ::close(it->second.fd);
+  m_segments.erase(it);
+
+  boost::system::error_code ec;
+  boost::filesystem::remove(getSegmentPath(segment), ec);
+  if (ec)
+    NDN_LOG_ERROR("Failed to remove " << getSegmentPath(segment) << ": " << ec.message());
+  else
+    NDN_LOG_DEBUG("Removed segment: " << getSegmentPath(segment));
+}
+
+uint64_t
+LogStore::recoverSegment(uint32_t segment)
+{
+  int fd = m_segments.at(segment).fd;
+  uint64_t offset = 0;
+  uint8_t header[RECORD_HEADER_SIZE];
+
+  while (util::readFully<Error>(fd, header, RECORD_HEADER_SIZE, offset) == RECORD_HEADER_SIZE) {
+    uint32_t magic = util::getUint32(header);
+    uint32_t length = util::getUint32(header + 4);
+    if ((magic != RECORD_MAGIC && magic != TOMBSTONE_MAGIC) || length == 0 || length > ndn::MAX_NDN_PACKET_SIZE) {
+      NDN_LOG_WARN("Invalid record header in " << getSegmentPath(segment) << " at: " << offset);
+      break;
+    }
+
+    auto buffer = std::make_shared<ndn::Buffer>(length);
+    if (util::readFully<Error>(fd, buffer->data(), length, offset + RECORD_HEADER_SIZE) != length ||
+        util::computeCrc(buffer->data(), length) != util::getUint32(header + 8)) {
+      NDN_LOG_WARN("Torn or corrupted record in " << getSegmentPath(segment) << " at: " << offset);
+      break;
+    }
+
+    try {
+      if (magic == TOMBSTONE_MAGIC) {
+        erase(ndn::Name(ndn::Block(std::move(buffer))), false);
+        ++m_segments.at(segment).nTombstones;
+      }
+      else {
+        ndn::Data data(ndn::Block(std::move(buffer)));
+        index(data.getName(), Location{segment, offset + RECORD_HEADER_SIZE, length, util::getUint64(header + 12)});
+      }
+    }
+    catch (const std::exception& e) {
+      NDN_LOG_WARN("Undecodable record in " << getSegmentPath(segment) << " at: " << offset << " " << e.what());
+      break;
+    }
+    offset += RECORD_HEADER_SIZE + length;
+  }
+  return offset;
+}
+
+void
+LogStore::index(const ndn::Name& name, const Location& location)
+{
+  auto [it, isNew] = m_index.try_emplace(name, IndexEntry{location, m_expiryQueue.end()});
+  if (isNew) {
+    m_orderedIndex.insert(&it->first);
+  }
+  else {
+    // the older record is garbage now
+    m_segments.at(it->second.segment).liveBytes -= RECORD_HEADER_SIZE + it->second.length;
+    static_cast<Location&>(it->second) = location;
+  }
+  m_segments.at(location.segment).liveBytes += RECORD_HEADER_SIZE + location.length;
+  scheduleExpiry(it);
+}
+
+void
+LogStore::scheduleExpiry(HashIndex::iterator it)
+{
+  if (it->second.expiry != m_expiryQueue.end()) {
+    m_expiryQueue.erase(it->second.expiry);
+    it->second.expiry = m_expiryQueue.end();
+  }
+
+  if (!m_getTtl)
+    return;
+  if (auto ttl = m_getTtl(it->first))
+    it->second.expiry = m_expiryQueue.emplace(it->second.time + static_cast<uint64_t>(ttl->count()), &it->first);
+}
+
+LogStore::Location
+LogStore::append(uint32_t magic, const ndn::Block& wire, uint64_t time)
+{
+  if (getActiveSegment().size > 0 && getActiveSegment().size + RECORD_HEADER_SIZE + wire.size() > m_segmentSize) {
+    sync();
+    openSegment(getActiveSegmentNo() + 1);
+    NDN_LOG_DEBUG("Started segment: " << getSegmentPath(getActiveSegmentNo()));
+  }
+
+  std::vector<uint8_t> record(RECORD_HEADER_SIZE + wire.size());
+  util::putUint32(record.data(), magic);
+  util::putUint32(record.data() + 4, wire.size());
+  util::putUint32(record.data() + 8, util::computeCrc(wire.wire(), wire.size()));
+  util::putUint64(record.data() + 12, time);
+  std::copy(wire.begin(), wire.end(), record.begin() + RECORD_HEADER_SIZE);
+
+  auto& segment = getActiveSegment();
+  uint64_t offset = segment.size;
+  util::writeFully<Error>(segment.fd, record.data(), record.size(), offset);
+  segment.size += record.size();
+  if (magic == TOMBSTONE_MAGIC)
+    ++segment.nTombstones;
+  return Location{getActiveSegmentNo(), offset + RECORD_HEADER_SIZE, static_cast<uint32_t>(wire.size()), time};
+}
+
+void
+LogStore::insert(const ndn::Data& data)
+{
+  index(data.getName(), append(RECORD_MAGIC, data.wireEncode(), toMilliseconds(ndn::time::system_clock::now())));
+}
+
+std::shared_ptr<ndn::Data>
+LogStore::readAt(const Location& location) const
+{
+  auto buffer = std::make_shared<ndn::Buffer>(location.length);
+  if (util::readFully<Error>(m_segments.at(location.segment).fd, buffer->data(), location.length,
+                location.offset) != location.length) {
+    NDN_THROW(Error("Record is beyond the end of " + getSegmentPath(location.segment)));
+  }
+  return std::make_shared<ndn::Data>(ndn::Block(std::move(buffer)));
+}
+
+std::shared_ptr<ndn::Data>
+LogStore::read(const ndn::Name& name) const
+{
+  auto it = m_index.find(name);
+  return it == m_index.end() ? nullptr : readAt(it->second);
+}
+
+std::shared_ptr<ndn::Data>
+LogStore::find(const ndn::Interest& interest) const
+{
+  const auto& name = interest.getName();
+  if (!name.empty() && name.get(-1).isImplicitSha256Digest()) {
+    auto data = read(name.getPrefix(-1));
+    return (data && data->getFullName() == name) ? data : nullptr;
+  }
+
+  auto data = read(name);
+  if (data || !interest.getCanBePrefix())
+    return data;
+
+  // first (canonical order) packet under the prefix
+  auto it = m_orderedIndex.lower_bound(&name);
+  return (it != m_orderedIndex.end() && name.isPrefixOf(**it)) ? read(**it) : nullptr;
+}
+
+bool
+LogStore::erase(const ndn::Name& name, bool isDurable)
+{
+  auto it = m_index.find(name);
+  if (it == m_index.end())
+    return false;
+
+  if (isDurable) {
+    append(TOMBSTONE_MAGIC, name.wireEncode(), toMilliseconds(ndn::time::system_clock::now()));
+  }
+  m_segments.at(it->second.segment).liveBytes -= RECORD_HEADER_SIZE + it->second.length;
+  if (it->second.expiry != m_expiryQueue.end())
+    m_expiryQueue.erase(it->second.expiry);
+  m_orderedIndex.erase(&it->first);
+  m_index.erase(it);
+  return true;
+}
+
+void
+LogStore::sync()
+{
+  if (::fdatasync(getActiveSegment().fd) != 0)
+    NDN_LOG_ERROR("Failed to sync " << getSegmentPath(getActiveSegmentNo()) << ": " << std::strerror(errno));
+}
+
+uint64_t
+LogStore::getStorageSize() const
+{
+  uint64_t size = 0;
+  for (const auto& segment : m_segments) {
+    size += segment.second.size;
+  }
+  return size;
+}
+
+void
+LogStore::setTtlFunction(const TtlFunction& getTtl)
+{
+  m_getTtl = getTtl;
+  m_expiryQueue.clear();
+  for (auto it = m_index.begin(); it != m_index.end(); ++it) {
+    it->second.expiry = m_expiryQueue.end();
+    scheduleExpiry(it);
+  }
+}
+
+size_t
+LogStore::expire(size_t maxPackets)
+{
+  auto now = toMilliseconds(ndn::time::system_clock::now());
+  size_t nExpired = 0;
+  while (nExpired < maxPackets && !m_expiryQueue.empty() && m_expiryQueue.begin()->first <= now) {
+    // the queue points to the index key, erase() removes it
+    ndn::Name name = *m_expiryQueue.begin()->second;
+    erase(name, true);
+    ++nExpired;
+  }
+
+  if (nExpired > 0)
+    NDN_LOG_DEBUG("Expired " << nExpired << " packets in " << m_path);
+  return nExpired;
+}
+
+size_t
+LogStore::compact(size_t maxBytes)
+{
+  if (!m_compactSegment) {
+    // oldest sealed segment that is at least half garbage
+    for (const auto& [segmentNo, segment] : m_segments) {
+      if (segmentNo == getActiveSegmentNo())
+        break;
+      if (segment.liveBytes * 2 <= segment.size) {
+        m_compactSegment = segmentNo;
+        m_compactOffset = 0;
+        NDN_LOG_DEBUG("Compacting " << getSegmentPath(segmentNo) << " live bytes: " << segment.liveBytes
+                      << " of: " << segment.size);
+        break;
+      }
+    }
+    if (!m_compactSegment)
+      return 0;
+  }
+
+  auto segmentNo = *m_compactSegment;
+  auto& segment = m_segments.at(segmentNo);
+  // tombstones of the oldest segment have nothing left to erase
+  bool isOldest = segmentNo == m_segments.begin()->first;
+  if (segment.liveBytes == 0 && (isOldest || segment.nTombstones == 0))
+    m_compactOffset = segment.size; // nothing to copy
+
+  size_t nProcessed = 0;
+  uint8_t header[RECORD_HEADER_SIZE];
+  while (m_compactOffset < segment.size && nProcessed < maxBytes) {
+    if (util::readFully<Error>(segment.fd, header, RECORD_HEADER_SIZE, m_compactOffset) != RECORD_HEADER_SIZE)
+      NDN_THROW(Error("Record header is beyond the end of " + getSegmentPath(segmentNo)));
+
+    uint32_t magic = util::getUint32(header);
+    Location location{segmentNo, m_compactOffset + RECORD_HEADER_SIZE, util::getUint32(header + 4), util::getUint64(header + 12)};
+    m_compactOffset += RECORD_HEADER_SIZE + location.length;
+    nProcessed += RECORD_HEADER_SIZE + location.length;
+
+    if (magic == TOMBSTONE_MAGIC) {
+      if (isOldest)
+        continue;
+      auto buffer = std::make_shared<ndn::Buffer>(location.length);
+      util::readFully<Error>(segment.fd, buffer->data(), location.length, location.offset);
+      ndn::Block nameWire(std::move(buffer));
+      // superseded if the name was inserted again
+      if (m_index.count(ndn::Name(nameWire)) == 0)
+        append(TOMBSTONE_MAGIC, nameWire, location.time);
+      continue;
+    }
+
+    if (segment.liveBytes == 0) // everything left is garbage
+      continue;
+
+    auto data = readAt(location);
+    auto it = m_index.find(data->getName());
+    if (it == m_index.end() || it->second.segment != segmentNo || it->second.offset != location.offset)
+      continue; // shadowed, erased or expired
+
+    index(data->getName(), append(RECORD_MAGIC, data->wireEncode(), location.time));
+  }
+
+  if (m_compactOffset >= segment.size) {
+    // copies are durable before the originals go away
+    sync();
+    removeSegment(segmentNo);
+    m_compactSegment = std::nullopt;
+  }
+  return std::max<size_t>(nProcessed, 1);
+}
+
+} // repo
+} // mguard
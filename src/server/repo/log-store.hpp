@@ -0,0 +1,268 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MGUARD_REPO_LOG_STORE_HPP
+#define MGUARD_REPO_LOG_STORE_HPP
+
+#include <ndn-cxx/data.hpp>
+#include <ndn-cxx/interest.hpp>
+
+#include <boost/noncopyable.hpp>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mguard {
+namespace repo {
+
+/*
+  Append-only, log-structured packet store.
+
+  Packets are appended to segment files (<path>/segment-<n>.log) as records
+  [magic (4) | length (4) | crc32 (4) | insertion time (8) | data wire], erased packets as
+  tombstone records carrying the name. A new segment is started once the active
+  one reaches the segment size. Two in-memory indexes point into the log: a hash index
+  name -> location for exact lookups and an ordered index over the same names for prefix
+  (CanBePrefix) lookups. A newer packet with the same name shadows the older record.
+
+  The indexes are rebuilt on open by scanning the segments. A torn or corrupted record
+  (e.g. after a crash in the middle of an append) ends the scan of its segment, the active
+  segment is truncated to the last good record.
+
+  Retention: with a TTL function, packets that have a TTL are also kept in an expiry queue
+  ordered by insertion time + TTL. expire() erases packets from its head, i.e. in the order they
+  become due and without looking at packets kept longer, and appends a tombstone for each, so an
+  expired packet stays gone after a restart even if the TTL is raised or removed meanwhile.
+  compact() reclaims the space: a sealed segment that is at least half garbage (shadowed, erased
+  or expired records) is rewritten incrementally, its live records and (unless it is the oldest
+  segment) its tombstones are appended again with their original insertion time, then the file
+  is removed.
+*/
+class LogStore : boost::noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    using std::runtime_error::runtime_error;
+  };
+
+  // TTL of a packet by name, nullopt if it is kept forever
+  using TtlFunction = std::function<std::optional<ndn::time::milliseconds>(const ndn::Name&)>;
+
+  /**
+   * @param path directory of the segment files, created if it doesn't exist
+   * @param segmentSize size after which a new segment file is started
+   * @throw Error if the directory or a segment can't be opened
+  */
+  LogStore(const std::string& path, size_t segmentSize);
+
+  ~LogStore();
+
+  /**
+   * @brief Append a packet to the log
+   * @throw Error if the write fails
+  */
+  void
+  insert(const ndn::Data& data);
+
+  /**
+   * @brief Find a packet satisfying the interest (exact name, full name with implicit
+   *  digest or first packet under the name with CanBePrefix)
+   * @return the packet or nullptr
+  */
+  std::shared_ptr<ndn::Data>
+  find(const ndn::Interest& interest) const;
+
+  /**
+   * @brief Read the packet with exactly this name
+   * @return the packet or nullptr
+  */
+  std::shared_ptr<ndn::Data>
+  read(const ndn::Name& name) const;
+
+  /**
+   * @brief Remove the packet. A tombstone record is appended such that the packet
+   *  is not indexed again on recovery, the space is not reclaimed.
+   * @return true if the packet was stored
+  */
+  bool
+  erase(const ndn::Name& name)
+  {
+    return erase(name, true);
+  }
+
+  /**
+   * @brief Flush appended records of the active segment to disk (fsync)
+  */
+  void
+  sync();
+
+  /**
+   * @brief Set the TTLs expire() applies, replaces earlier ones. The expiry queue is rebuilt
+   *  from the insertion times, nullptr keeps all packets.
+  */
+  void
+  setTtlFunction(const TtlFunction& getTtl);
+
+  /**
+   * @brief Erase the packets whose TTL has passed, oldest deadline first, with a tombstone each
+   * @param maxPackets number of packets erased at most
+   * @return number of packets erased, maxPackets if more may be due
+   * @throw Error if a write fails
+  */
+  size_t
+  expire(size_t maxPackets);
+
+  /**
+   * @brief Continue reclaiming the space of the oldest sealed segment that is mostly garbage
+   * @param maxBytes bytes read (and at most written) by this call
+   * @return number of bytes processed, 0 if no segment needs to be compacted
+   * @throw Error if a read or write fails
+  */
+  size_t
+  compact(size_t maxBytes);
+
+  // number of packets in the index
+  size_t
+  size() const
+  {
+    return m_index.size();
+  }
+
+  size_t
+  getSegmentCount() const
+  {
+    return m_segments.size();
+  }
+
+  // bytes of all the segments, including garbage
+  uint64_t
+  getStorageSize() const;
+
+private:
+  struct Location
+  {
+    uint32_t segment;
+    uint64_t offset; // of the data wire, i.e. after the record header
+    uint32_t length;
+    uint64_t time; // insertion, milliseconds since the epoch
+  };
+
+  struct Segment
+  {
+    int fd;
+    uint64_t size = 0;
+    uint64_t liveBytes = 0; // records the index points to
+    size_t nTombstones = 0;
+  };
+
+  struct NamePtrLess
+  {
+    bool
+    operator()(const ndn::Name* lhs, const ndn::Name* rhs) const
+    {
+      return *lhs < *rhs;
+    }
+  };
+
+  // deadline (insertion + TTL, milliseconds since the epoch) -> name
+  using ExpiryQueue = std::multimap<uint64_t, const ndn::Name*>;
+
+  struct IndexEntry : Location
+  {
+    ExpiryQueue::iterator expiry; // end() if the packet is kept forever
+  };
+
+  // hash index, node based, the ordered index and the expiry queue point to its keys
+  using HashIndex = std::unordered_map<ndn::Name, IndexEntry>;
+
+  std::string
+  getSegmentPath(uint32_t segment) const;
+
+  Segment&
+  getActiveSegment()
+  {
+    return m_segments.rbegin()->second;
+  }
+
+  uint32_t
+  getActiveSegmentNo() const
+  {
+    return m_segments.rbegin()->first;
+  }
+
+  void
+  openSegment(uint32_t segment);
+
+  void
+  removeSegment(uint32_t segment);
+
+  /**
+   * @brief Scan a segment and index its records
+   * @return size of the valid part of the segment
+  */
+  uint64_t
+  recoverSegment(uint32_t segment);
+
+  void
+  index(const ndn::Name& name, const Location& location);
+
+  bool
+  erase(const ndn::Name& name, bool isDurable);
+
+  // (re)queue the packet for expiry by its insertion time
+  void
+  scheduleExpiry(HashIndex::iterator it);
+
+  /**
+   * @brief Append a record to the active segment, start a new segment if it is full
+   * @return location of the record payload in the active segment
+  */
+  Location
+  append(uint32_t magic, const ndn::Block& wire, uint64_t time);
+
+  std::shared_ptr<ndn::Data>
+  readAt(const Location& location) const;
+
+private:
+  std::string m_path;
+  size_t m_segmentSize;
+  std::map<uint32_t, Segment> m_segments; // by segment number, the last one is active
+
+  HashIndex m_index;
+  std::set<const ndn::Name*, NamePtrLess> m_orderedIndex;
+
+  TtlFunction m_getTtl;
+  ExpiryQueue m_expiryQueue;
+
+  std::optional<uint32_t> m_compactSegment; // segment being compacted
+  uint64_t m_compactOffset = 0;
+};
+
+} // repo
+} // mguard
+
+#endif // MGUARD_REPO_LOG_STORE_HPP
@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "native-repo.hpp"
+#include "../../common.hpp"
+
+#include <ndn-cxx/util/logger.hpp>
+
+namespace mguard {
+namespace repo {
+
+NDN_LOG_INIT(mguard.repo.NativeRepo);
+
+NativeRepo::NativeRepo(ndn::Face& face, const std::vector<std::string>& paths, size_t segmentSize,
+                       ndn::time::milliseconds syncInterval)
+: m_face(face)
+, m_scheduler(m_face.getIoService())
+, m_isDirty(paths.size(), false)
+, m_syncInterval(syncInterval)
+{
+  if (paths.empty())
+    NDN_THROW(LogStore::Error("At least one storage path is needed"));
+
+  for (const auto& path : paths) {
+    m_shards.push_back(std::make_unique<LogStore>(path, segmentSize));
+  }
+}
+
+void
+NativeRepo::insert(const ndn::Data& data, const ndn::Name& shardKey)
+{
+  size_t shard = std::hash<ndn::Name>()(shardKey.empty() ? data.getName() : shardKey) % m_shards.size();
+  m_shards[shard]->insert(data);
+  m_isDirty[shard] = true;
+  NDN_LOG_TRACE("Stored: " << data.getName() << " in shard: " << shard);
+
+  if (!m_isSyncScheduled) {
+    m_isSyncScheduled = true;
+    m_syncEvent = m_scheduler.schedule(m_syncInterval, [this] {
+      m_isSyncScheduled = false;
+      for (size_t i = 0; i < m_shards.size(); ++i) {
+        if (m_isDirty[i])
+          m_shards[i]->sync();
+        m_isDirty[i] = false;
+      }
+    });
+  }
+}
+
+std::shared_ptr<ndn::Data>
+NativeRepo::find(const ndn::Interest& interest) const
+{
+  // the shard key (stream) isn't known from the interest, the index lookups are cheap
+  for (const auto& shard : m_shards) {
+    if (auto data = shard->find(interest))
+      return data;
+  }
+  return nullptr;
+}
+
+void
+NativeRepo::setRetentionPolicy(const RetentionPolicy& policy)
+{
+  m_retentionPolicy = policy;
+  m_retentionEvent.cancel();
+  for (auto& shard : m_shards) {
+    if (m_retentionPolicy.empty())
+      shard->setTtlFunction(nullptr);
+    else
+      shard->setTtlFunction([this] (const ndn::Name& name) { return m_retentionPolicy.getTtl(name); });
+  }
+  if (!m_retentionPolicy.empty())
+    scheduleRetentionSweep(RETENTION_SWEEP_INTERVAL);
+}
+
+void
+NativeRepo::scheduleRetentionSweep(ndn::time::milliseconds delay)
+{
+  m_retentionEvent = m_scheduler.schedule(delay, [this] {
+    // behind ingest, continue right after the other queued events
+    scheduleRetentionSweep(sweep() ? ndn::time::milliseconds(0) : RETENTION_SWEEP_INTERVAL);
+  });
+}
+
+bool
+NativeRepo::sweep()
+{
+  bool isBehind = false;
+  for (auto& shard : m_shards) {
+    try {
+      isBehind |= shard->expire(RETENTION_EXPIRE_BATCH) == RETENTION_EXPIRE_BATCH;
+      shard->compact(RETENTION_COMPACT_BYTES);
+    }
+    catch (const LogStore::Error& e) {
+      NDN_LOG_ERROR("Retention sweep failed: " << e.what());
+    }
+  }
+  return isBehind;
+}
+
+void
+NativeRepo::listen(const ndn::Name& prefix)
+{
+  NDN_LOG_INFO("Serving prefix: " << prefix);
+  m_prefixHandles.emplace_back(m_face.setInterestFilter(prefix,
+    [this] (const auto&, const auto& interest) { onInterest(interest); },
+    [] (const ndn::Name& name) { NDN_LOG_INFO("Successfully registered prefix: " << name); },
+    [] (const ndn::Name& name, const std::string& reason) {
+      NDN_LOG_ERROR("Failed to register prefix: " << name << " " << reason);
+    }));
+}
+
+void
+NativeRepo::onInterest(const ndn::Interest& interest)
+{
+  try {
+    if (auto data = find(interest)) {
+      m_face.put(*data);
+      return;
+    }
+  }
+  catch (const std::exception& e) {
+    NDN_LOG_ERROR("Failed to read: " << interest.getName() << " " << e.what());
+  }
+  NDN_LOG_TRACE("No packet for: " << interest);
+}
+
+} // repo
+} // mguard
@@ -0,0 +1,124 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MGUARD_REPO_NATIVE_REPO_HPP
+#define MGUARD_REPO_NATIVE_REPO_HPP
+
+#include "log-store.hpp"
+#include "retention-policy.hpp"
+
+#include <ndn-cxx/face.hpp>
+#include <ndn-cxx/util/scheduler.hpp>
+
+namespace mguard {
+namespace repo {
+
+/*
+  Embedded repo, replaces ndn-python-repo.
+
+  Packets are stored in LogStores and served from them. Each storage path is a shard with its own
+  log and index, e.g. one per disk, a packet goes to the shard of its shard key (the stream name)
+  and lookups check all shards. It either runs in the producer process,
+  where the publisher inserts packets directly and answers Interests from it on its own interest
+  filter, or standalone (mguard-repo), where it registers the prefixes given by listen() and
+  receives packets over TCP the same way ndn-python-repo does.
+
+  Appends are flushed to disk (fdatasync) at most every sync interval (group commit), a crash
+  loses at most the packets of the last interval, recovery drops the torn tail.
+
+  With a retention policy, a background sweep every RETENTION_SWEEP_INTERVAL expires up to
+  RETENTION_EXPIRE_BATCH due packets and compacts up to RETENTION_COMPACT_BYTES of each shard, so
+  the I/O of retention is bounded and spread out. A sweep that found a full batch due runs again
+  right away instead of after the interval, expiry keeps up with ingest.
+*/
+class NativeRepo : boost::noncopyable
+{
+public:
+  /**
+   * @param paths storage path of each shard
+  */
+  NativeRepo(ndn::Face& face, const std::vector<std::string>& paths, size_t segmentSize,
+             ndn::time::milliseconds syncInterval);
+
+  /**
+   * @brief Store the packet
+   * @param shardKey packets with the same key are stored in the same shard, the packet name
+   *  is used if empty
+   * @throw LogStore::Error if the write fails
+  */
+  void
+  insert(const ndn::Data& data, const ndn::Name& shardKey = ndn::Name());
+
+  std::shared_ptr<ndn::Data>
+  find(const ndn::Interest& interest) const;
+
+  /**
+   * @brief Start expiring packets according to the policy, replaces an earlier policy
+  */
+  void
+  setRetentionPolicy(const RetentionPolicy& policy);
+
+  /**
+   * @brief Register the prefix and serve Interests under it from the store
+  */
+  void
+  listen(const ndn::Name& prefix);
+
+  size_t
+  getShardCount() const
+  {
+    return m_shards.size();
+  }
+
+  LogStore&
+  getShard(size_t shard)
+  {
+    return *m_shards.at(shard);
+  }
+
+private:
+  void
+  onInterest(const ndn::Interest& interest);
+
+  void
+  scheduleRetentionSweep(ndn::time::milliseconds delay);
+
+  /**
+   * @return true if a shard may have more packets due than one batch
+  */
+  bool
+  sweep();
+
+private:
+  ndn::Face& m_face;
+  ndn::Scheduler m_scheduler;
+  std::vector<std::unique_ptr<LogStore>> m_shards;
+  std::vector<bool> m_isDirty; // shards with appends not synced yet
+  ndn::time::milliseconds m_syncInterval;
+  ndn::scheduler::ScopedEventId m_syncEvent;
+  bool m_isSyncScheduled = false;
+  RetentionPolicy m_retentionPolicy;
+  ndn::scheduler::ScopedEventId m_retentionEvent;
+  std::vector<ndn::ScopedRegisteredPrefixHandle> m_prefixHandles;
+};
+
+} // repo
+} // mguard
+
+#endif // MGUARD_REPO_NATIVE_REPO_HPP
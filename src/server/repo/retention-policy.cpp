@@ -0,0 +1,41 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "retention-policy.hpp"
+
+namespace mguard {
+namespace repo {
+
+std::optional<ndn::time::milliseconds>
+RetentionPolicy::getTtl(const ndn::Name& name) const
+{
+  // a handful of streams, no need for a prefix tree
+  const ndn::Name* longest = nullptr;
+  std::optional<ndn::time::milliseconds> ttl = m_defaultTtl;
+  for (const auto& [prefix, prefixTtl] : m_ttls) {
+    if ((!longest || prefix.size() > longest->size()) && prefix.isPrefixOf(name)) {
+      longest = &prefix;
+      ttl = prefixTtl;
+    }
+  }
+  return ttl;
+}
+
+} // repo
+} // mguard
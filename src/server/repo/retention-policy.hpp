@@ -0,0 +1,70 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MGUARD_REPO_RETENTION_POLICY_HPP
+#define MGUARD_REPO_RETENTION_POLICY_HPP
+
+#include <ndn-cxx/name.hpp>
+#include <ndn-cxx/util/time.hpp>
+
+#include <map>
+#include <optional>
+
+namespace mguard {
+namespace repo {
+
+/*
+  Per-stream TTLs of stored packets, by name prefix (the stream name covers its data, metadata,
+  manifest and manifest index packets). The longest matching prefix wins, names that match no
+  prefix (e.g. content keys) get the default TTL, packets without a TTL are kept forever.
+*/
+class RetentionPolicy
+{
+public:
+  void
+  setTtl(const ndn::Name& prefix, ndn::time::milliseconds ttl)
+  {
+    m_ttls[prefix] = ttl;
+  }
+
+  void
+  setDefaultTtl(ndn::time::milliseconds ttl)
+  {
+    m_defaultTtl = ttl;
+  }
+
+  std::optional<ndn::time::milliseconds>
+  getTtl(const ndn::Name& name) const;
+
+  // whether every packet is kept forever
+  bool
+  empty() const
+  {
+    return m_ttls.empty() && !m_defaultTtl;
+  }
+
+private:
+  std::map<ndn::Name, ndn::time::milliseconds> m_ttls;
+  std::optional<ndn::time::milliseconds> m_defaultTtl;
+};
+
+} // repo
+} // mguard
+
+#endif // MGUARD_REPO_RETENTION_POLICY_HPP
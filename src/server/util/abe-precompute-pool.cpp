@@ -0,0 +1,154 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "abe-precompute-pool.hpp"
+
+#include <ndn-cxx/security/signing-helpers.hpp>
+#include <ndn-cxx/util/logger.hpp>
+
+#include <algorithm>
+
+namespace mguard {
+namespace util {
+
+NDN_LOG_INIT(mguard.util.AbePrecomputePool);
+
+// name suffix of the throw-away data packets used to warm the content key cache
+const ndn::Name WARM_UP_NAME("/mguard/PRECOMPUTE");
+const uint8_t WARM_UP_CONTENT[] = {0};
+
+AbePrecomputePool::AbePrecomputePool(ndn::Scheduler& scheduler, const WarmUpFunction& warmUp,
+                                     ndn::time::milliseconds idleTime)
+: m_scheduler(scheduler)
+, m_warmUp(warmUp)
+, m_idleTime(idleTime)
+{
+}
+
+AbePrecomputePool::AbePrecomputePool(ndn::Scheduler& scheduler, ndn::nacabe::CacheProducer& producer,
+                                     ndn::time::milliseconds idleTime)
+: AbePrecomputePool(scheduler, [&producer] (const std::vector<std::string>& attributes) {
+    auto [data, ckData] = producer.produce(WARM_UP_NAME, attributes, {WARM_UP_CONTENT, sizeof(WARM_UP_CONTENT)},
+                                           ndn::security::signingWithSha256());
+    // without the public parameters nothing is produced, and no content key is kept
+    return data != nullptr && ckData != nullptr;
+  }, idleTime)
+{
+}
+
+std::string
+AbePrecomputePool::makeKey(const std::vector<std::string>& attributes)
+{
+  // same order sensitivity as the CacheProducer key
+  std::string key;
+  for (const auto& attr : attributes) {
+    key += attr;
+    key += '|';
+  }
+  return key;
+}
+
+AbePrecomputePool::EntryList::iterator
+AbePrecomputePool::touch(const std::vector<std::string>& attributes)
+{
+  auto key = makeKey(attributes);
+  auto itr = m_index.find(key);
+  if (itr != m_index.end()) {
+    m_entries.splice(m_entries.begin(), m_entries, itr->second);
+    return itr->second;
+  }
+
+  // not dropped later on, CacheProducer keeps the content key of every set it has produced with
+  m_entries.push_front(Entry{attributes, false});
+  m_index.emplace(key, m_entries.begin());
+  return m_entries.begin();
+}
+
+void
+AbePrecomputePool::addExpectedAttributes(const std::vector<std::string>& attributes)
+{
+  if (attributes.empty())
+    return;
+
+  touch(attributes);
+  scheduleWarmUp(m_idleTime);
+}
+
+bool
+AbePrecomputePool::recordUse(const std::vector<std::string>& attributes)
+{
+  auto entry = touch(attributes);
+  bool isHit = entry->isWarm;
+  if (isHit) {
+    ++m_nHits;
+  }
+  else {
+    ++m_nMisses;
+    // the caller is about to produce with this set, CacheProducer will keep its key
+    entry->isWarm = true;
+    ++m_nWarm;
+  }
+
+  // activity, push the warm-up back until the producer is idle again
+  scheduleWarmUp(m_idleTime);
+  return isHit;
+}
+
+void
+AbePrecomputePool::scheduleWarmUp(ndn::time::milliseconds delay)
+{
+  if (m_nWarm == m_entries.size()) {
+    m_warmUpEvent.cancel();
+    return;
+  }
+  m_warmUpEvent = m_scheduler.schedule(delay, [this] { warmUpNext(); });
+}
+
+void
+AbePrecomputePool::warmUpNext()
+{
+  // most recently used sets are warmed first
+  auto entry = std::find_if(m_entries.begin(), m_entries.end(),
+                            [] (const Entry& e) { return !e.isWarm; });
+  if (entry == m_entries.end())
+    return;
+
+  NDN_LOG_DEBUG("Precomputing content key for attribute set: " << makeKey(entry->attributes));
+  bool isWarm = false;
+  try {
+    isWarm = m_warmUp(entry->attributes);
+  }
+  catch (const std::exception& e) {
+    NDN_LOG_DEBUG("Precomputation failed: " << e.what());
+  }
+  if (!isWarm) {
+    // most likely the public parameters are not fetched yet, try again after the next idle period
+    scheduleWarmUp(m_idleTime);
+    return;
+  }
+  entry->isWarm = true;
+  ++m_nWarm;
+
+  NDN_LOG_TRACE("Precompute pool size: " << m_nWarm << "/" << m_entries.size());
+  // yield to the face between two sets
+  scheduleWarmUp(ndn::time::milliseconds(0));
+}
+
+} // util
+} // mguard
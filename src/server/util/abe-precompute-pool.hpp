@@ -0,0 +1,156 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MGUARD_UTIL_ABE_PRECOMPUTE_POOL_HPP
+#define MGUARD_UTIL_ABE_PRECOMPUTE_POOL_HPP
+
+#include <nac-abe/cache-producer.hpp>
+
+#include <ndn-cxx/util/scheduler.hpp>
+
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mguard {
+namespace util {
+
+/*
+  Precomputation pool for the NAC-ABE CacheProducer.
+
+  The expensive part of KP-ABE encryption is the generation of the content key (CK) for an
+  attribute set, which does not depend on the plaintext. CacheProducer keeps one CK per attribute
+  set, so we can do that work up front: once the producer has been idle for PRECOMPUTE_IDLE_TIME,
+  the pool warms the CacheProducer for every expected attribute set that is not warm yet
+  (one set per scheduler round, so the face is never blocked for long). During a burst only
+  the symmetric part of the encryption is left.
+
+  Expected attribute sets come from the attribute mapping table (seeded by the DataAdapter)
+  and from recent history (every set passed to recordUse). CacheProducer never drops a content
+  key, so neither does the pool: it is sized by the mapping table and the sets actually used, and
+  a hit is a content key reused by CacheProducer.
+*/
+class AbePrecomputePool
+{
+public:
+  /**
+   * @brief Prepare the content key of an attribute set
+   * @return false if it can't be done yet (e.g. no public parameters), it is tried again later
+  */
+  using WarmUpFunction = std::function<bool(const std::vector<std::string>& attributes)>;
+
+  AbePrecomputePool(ndn::Scheduler& scheduler, const WarmUpFunction& warmUp,
+                    ndn::time::milliseconds idleTime);
+
+  /**
+   * @brief Warm the CacheProducer by producing a throw-away packet with each set
+  */
+  AbePrecomputePool(ndn::Scheduler& scheduler, ndn::nacabe::CacheProducer& producer,
+                    ndn::time::milliseconds idleTime);
+
+  /**
+   * @brief Add an attribute set that is expected to be used for encryption later on.
+   *  The set is warmed during the next idle period.
+   * @param attributes attribute list, in the same order as given to produce()
+  */
+  void
+  addExpectedAttributes(const std::vector<std::string>& attributes);
+
+  /**
+   * @brief Record that an attribute set is about to be used for encryption, and
+   *  (re)start the idle timer.
+   * @return true if the content key for the set was already prepared (pool hit)
+  */
+  bool
+  recordUse(const std::vector<std::string>& attributes);
+
+  // number of attribute sets with a prepared content key
+  size_t
+  getPoolSize() const
+  {
+    return m_nWarm;
+  }
+
+  // number of attribute sets tracked by the pool (prepared or waiting for warm-up)
+  size_t
+  getTrackedSize() const
+  {
+    return m_entries.size();
+  }
+
+  uint64_t
+  getHitCount() const
+  {
+    return m_nHits;
+  }
+
+  uint64_t
+  getMissCount() const
+  {
+    return m_nMisses;
+  }
+
+  double
+  getHitRate() const
+  {
+    auto total = m_nHits + m_nMisses;
+    return total == 0 ? 0.0 : static_cast<double>(m_nHits) / total;
+  }
+
+private:
+  struct Entry
+  {
+    std::vector<std::string> attributes;
+    bool isWarm = false;
+  };
+
+  using EntryList = std::list<Entry>;
+
+  static std::string
+  makeKey(const std::vector<std::string>& attributes);
+
+  // find or insert a set and move it to the front (most recently used, warmed first)
+  EntryList::iterator
+  touch(const std::vector<std::string>& attributes);
+
+  void
+  scheduleWarmUp(ndn::time::milliseconds delay);
+
+  void
+  warmUpNext();
+
+private:
+  ndn::Scheduler& m_scheduler;
+  WarmUpFunction m_warmUp;
+  ndn::time::milliseconds m_idleTime;
+  ndn::scheduler::ScopedEventId m_warmUpEvent;
+
+  EntryList m_entries; // front is the most recently used
+  std::unordered_map<std::string, EntryList::iterator> m_index;
+  size_t m_nWarm = 0;
+  uint64_t m_nHits = 0;
+  uint64_t m_nMisses = 0;
+};
+
+} // util
+} // mguard
+
+#endif // MGUARD_UTIL_ABE_PRECOMPUTE_POOL_HPP
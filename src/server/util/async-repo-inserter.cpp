@@ -26,6 +26,8 @@
 #include <ndn-cxx/security/signing-helpers.hpp>
 
 #include "async-repo-inserter.hpp"
+#include "../repo/native-repo.hpp"
+#include "../../common.hpp"
 
 NDN_LOG_INIT(mguard.util.repoClient);
 
@@ -33,45 +35,96 @@ namespace mguard {
 namespace util {
 namespace bp = boost::asio::ip;
 
-AsyncRepoInserter::AsyncRepoInserter(boost::asio::io_service& io)
+AsyncRepoInserter::AsyncRepoInserter(boost::asio::io_service& io, repo::NativeRepo* nativeRepo,
+                                     size_t poolSize)
   : m_io(io)
-  , m_resolv(m_io)
-  , m_socket(std::make_shared<bp::tcp::socket>(m_io))
+  , m_nativeRepo(nativeRepo)
 {
+  if (m_nativeRepo)
+    return;
+
+  for (size_t i = 0; i < std::max<size_t>(poolSize, 1); ++i) {
+    auto journalPath = SPILL_JOURNAL_PATH + "/connection-" + std::to_string(i) + ".journal";
+    m_connections.push_back(std::make_unique<RepoConnection>(m_io, REPO_WRITE_BATCH_BYTES, REPO_WRITE_MAX_DELAY,
+                                                             journalPath));
+  }
 }
 
 void
 AsyncRepoInserter::AsyncConnectToRepo(const AsyncConnectHandler& connectHandler, const std::string& repoHost,
                                       const std::string& repoPort)
 {
-  bp::tcp::resolver::query query(repoHost, repoPort);
-  m_resolv.async_resolve(query, [this, connectHandler](auto& err, auto& it) {
-    NDN_LOG_TRACE("Resolvation status: " << err.message());
-    if (!err) {
-      m_socket->async_connect(*it, [this, connectHandler] (auto& err) {
-        NDN_LOG_DEBUG("Connnection status: " << err.message());
-        connectHandler(err);
-      });
-    }
-    else {
-      // NDN_THROW(std::runtime_error("Repo endpoint cannot be resolved: " << err.message())); 
-      // ---- debug why this line is not working
-      
-      NDN_LOG_TRACE("Repo endpoint cannot be resolved:");
-      exit(-1);
-    }
-  });  
+  AsyncConnectToRepos(connectHandler, {RepoEndpoint{repoHost, repoPort}});
 }
 
 void
-AsyncRepoInserter::AsyncWriteDataToRepo(const ndn::Data &data, const AsyncWriteHandler& writeHandler)
+AsyncRepoInserter::AsyncConnectToRepos(const AsyncConnectHandler& connectHandler,
+                                       const std::vector<RepoEndpoint>& endpoints)
 {
-  m_socket->async_send(boost::asio::buffer(data.wireEncode()), 
-    [this, data, writeHandler](auto& err, auto&&) {
-      writeHandler(data, err);
+  if (m_nativeRepo) {
+    NDN_LOG_DEBUG("Using in-process repo, no connection needed");
+    m_io.post([connectHandler] { connectHandler(AsyncRepoError()); });
+    return;
+  }
+
+  if (endpoints.empty())
+    NDN_THROW(Error("No repo endpoint given"));
+
+  // report once all the connections of the pool are attempted
+  auto nRemaining = std::make_shared<size_t>(m_connections.size());
+  auto lastError = std::make_shared<AsyncRepoError>();
+  for (size_t i = 0; i < m_connections.size(); ++i) {
+    const auto& endpoint = endpoints[i % endpoints.size()];
+    NDN_LOG_DEBUG("Connecting pool connection " << i << " to: " << endpoint.host << ":" << endpoint.port);
+    m_connections[i]->connect(endpoint, [=] (const AsyncRepoError& err) {
+      if (err)
+        *lastError = err;
+      if (--*nRemaining == 0)
+        connectHandler(*lastError);
+    });
+  }
+}
+
+RepoConnection&
+AsyncRepoInserter::getConnection(const ndn::Name& shardKey)
+{
+  return *m_connections[std::hash<ndn::Name>()(shardKey) % m_connections.size()];
+}
+
+void
+AsyncRepoInserter::AsyncWriteDataToRepo(const ndn::Data &data, const AsyncWriteHandler& writeHandler,
+                                        const ndn::Name& shardKey)
+{
+  const auto& key = shardKey.empty() ? data.getName() : shardKey;
+  if (m_nativeRepo) {
+    AsyncRepoError err;
+    try {
+      m_nativeRepo->insert(data, key);
+    }
+    catch (const std::exception& e) {
+      NDN_LOG_ERROR("Failed to store: " << data.getName() << " " << e.what());
+      err = boost::system::errc::make_error_code(boost::system::errc::io_error);
     }
-  );
+    m_io.post([name = data.getName(), writeHandler, err] { writeHandler(name, err); });
+    return;
+  }
+
+  getConnection(key).write(data.wireEncode(), data.getName(), writeHandler);
+}
+
+std::vector<AsyncRepoInserter::ConnectionStatus>
+AsyncRepoInserter::getStatus() const
+{
+  std::vector<ConnectionStatus> status;
+  for (const auto& connection : m_connections) {
+    status.push_back(ConnectionStatus{connection->getEndpoint(), connection->isConnected(),
+                                      connection->getQueueSize(), connection->getQueueBytes(),
+                                      connection->getWrittenCount(), connection->getErrorCount(),
+                                      connection->getSpilledCount(), connection->getReplayedCount(),
+                                      connection->getSpilledBytes()});
+  }
+  return status;
 }
 
 } // util
-} // mguard
\ No newline at end of file
+} // mguard
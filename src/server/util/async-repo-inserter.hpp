@@ -20,6 +20,8 @@
 #ifndef MGUARD_UTIL_ASYNC_REPO_INSERTER_HPP
 #define MGUARD_UTIL_ASYNC_REPO_INSERTER_HPP
 
+#include "repo-connection.hpp"
+
 #include <boost/asio.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <queue>
@@ -29,11 +31,11 @@
 #include <ndn-cxx/util/scheduler.hpp>
 
 namespace mguard {
+namespace repo {
+class NativeRepo;
+} // repo
+
 namespace util {
-namespace bp = boost::asio::ip;
-using AsyncRepoError = boost::system::error_code;
-using AsyncConnectHandler = std::function<void(const AsyncRepoError&)>;
-using AsyncWriteHandler = std::function<void(const ndn::Data&, const AsyncRepoError&)>;
 
 const std::string DEFAULT_HOST = "0.0.0.0";
 const std::string DEFAULT_PORT = "7376";
@@ -48,20 +50,62 @@ public:
     using std::runtime_error::runtime_error;
   };
 
+  struct ConnectionStatus
+  {
+    RepoEndpoint endpoint;
+    bool isConnected;
+    size_t queueSize;
+    size_t queueBytes;
+    uint64_t nWritten;
+    uint64_t nErrors;
+    uint64_t nSpilled;
+    uint64_t nReplayed;
+    uint64_t spilledBytes; // waiting in the journal
+  };
+
+  /**
+   * @param nativeRepo if given, packets are stored in this (in-process) repo instead of being sent
+   *  over TCP, handlers are still called asynchronously
+   * @param poolSize number of TCP connections, packets are sharded over them by stream. Each
+   *  connection spills to its own journal under SPILL_JOURNAL_PATH while the repo is unreachable.
+  */
   explicit
-  AsyncRepoInserter(boost::asio::io_service& io);
+  AsyncRepoInserter(boost::asio::io_service& io, repo::NativeRepo* nativeRepo = nullptr,
+                    size_t poolSize = 1);
 
   void
   AsyncConnectToRepo(const AsyncConnectHandler& connectHandler, const std::string& repoHost = DEFAULT_HOST,
                      const std::string& repoPort = DEFAULT_PORT);
 
+  /**
+   * @brief Connect the pool to one or more repos, connection i goes to endpoint i % endpoints.size().
+   *  connectHandler is called once all connections are attempted, with the last error if any failed.
+  */
   void
-  AsyncWriteDataToRepo(const ndn::Data& data, const AsyncWriteHandler& writeHandler);
+  AsyncConnectToRepos(const AsyncConnectHandler& connectHandler, const std::vector<RepoEndpoint>& endpoints);
+
+  /**
+   * @brief Queue the packet for insertion, packets are written in order and in batches
+   *  (see RepoConnection), writeHandler is called with the packet name once written
+   * @param shardKey packets with the same key go through the same connection (or native repo shard)
+   *  and keep their order, i.e. the stream name. The packet name is used if empty.
+  */
+  void
+  AsyncWriteDataToRepo(const ndn::Data& data, const AsyncWriteHandler& writeHandler,
+                       const ndn::Name& shardKey = ndn::Name());
+
+  // health and queue depth of each connection of the pool
+  std::vector<ConnectionStatus>
+  getStatus() const;
+
+private:
+  RepoConnection&
+  getConnection(const ndn::Name& shardKey);
 
 private:
   boost::asio::io_service& m_io;
-  bp::tcp::resolver m_resolv;
-  std::shared_ptr<bp::tcp::socket> m_socket;
+  std::vector<std::unique_ptr<RepoConnection>> m_connections;
+  repo::NativeRepo* m_nativeRepo;
 };
 
 } // util
@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "batching-policy.hpp"
+#include "../../common.hpp"
+
+#include <algorithm>
+
+namespace mguard {
+namespace util {
+
+// weight of the newest inter-arrival time in the moving average
+const double ARRIVAL_EWMA_WEIGHT = 0.2;
+
+BatchingPolicy::BatchingPolicy(size_t maxCount, size_t maxBytes, ndn::time::milliseconds maxAge,
+                               ndn::time::milliseconds idleTime)
+: m_minCount(maxCount)
+, m_maxCount(maxCount)
+, m_maxBytes(maxBytes)
+, m_maxAge(maxAge)
+, m_idleTime(idleTime)
+, m_targetCount(maxCount)
+{
+}
+
+BatchingPolicy
+BatchingPolicy::makeAdaptive(ndn::time::milliseconds targetLatency, size_t minCount, size_t maxCount,
+                             size_t maxBytes, ndn::time::milliseconds idleTime)
+{
+  BatchingPolicy policy(maxCount, maxBytes, targetLatency, idleTime);
+  policy.m_mode = Mode::ADAPTIVE;
+  policy.m_minCount = std::max<size_t>(1, std::min(minCount, maxCount));
+  // nothing is known about the stream yet, don't hold the first entry back
+  policy.m_targetCount = policy.m_minCount;
+  return policy;
+}
+
+BatchingPolicy
+BatchingPolicy::makeDefault()
+{
+  if (USE_ADAPTIVE_BATCHING)
+    return makeAdaptive(MANIFEST_TARGET_LATENCY, 1, MANIFEST_BATCH_SIZE, MANIFEST_BATCH_BYTES,
+                        MAX_UPDATE_WAIT_TIME);
+
+  return BatchingPolicy(MANIFEST_BATCH_SIZE, MANIFEST_BATCH_BYTES, MAX_MANIFEST_AGE, MAX_UPDATE_WAIT_TIME);
+}
+
+bool
+BatchingPolicy::onAppend(size_t entryBytes, const ndn::time::steady_clock::time_point& now)
+{
+  updateArrivalRate(now);
+
+  if (m_count == 0)
+    m_batchStart = now;
+
+  ++m_count;
+  m_bytes += entryBytes;
+
+  return m_count >= m_targetCount || m_bytes >= m_maxBytes || now - m_batchStart >= m_maxAge;
+}
+
+ndn::time::milliseconds
+BatchingPolicy::getFlushDelay(const ndn::time::steady_clock::time_point& now) const
+{
+  if (m_count == 0)
+    return m_idleTime;
+
+  auto age = ndn::time::duration_cast<ndn::time::milliseconds>(now - m_batchStart);
+  auto remaining = std::max(m_maxAge - age, ndn::time::milliseconds::zero());
+  return std::min(m_idleTime, remaining);
+}
+
+void
+BatchingPolicy::onFlush()
+{
+  m_count = 0;
+  m_bytes = 0;
+}
+
+double
+BatchingPolicy::getArrivalRate() const
+{
+  return m_avgInterval > 0 ? 1000.0 / m_avgInterval : 0;
+}
+
+void
+BatchingPolicy::updateArrivalRate(const ndn::time::steady_clock::time_point& now)
+{
+  bool isFirst = !m_hasArrival;
+  if (!isFirst) {
+    double interval = ndn::time::duration_cast<ndn::time::microseconds>(now - m_lastArrival).count() / 1000.0;
+    m_avgInterval = m_avgInterval == 0 ? interval
+                                       : ARRIVAL_EWMA_WEIGHT * interval + (1 - ARRIVAL_EWMA_WEIGHT) * m_avgInterval;
+  }
+  m_lastArrival = now;
+  m_hasArrival = true;
+
+  if (m_mode != Mode::ADAPTIVE || isFirst)
+    return;
+
+  if (m_avgInterval <= 0) {
+    // entries arrive back to back (e.g. one batch from the data generator)
+    m_targetCount = m_maxCount;
+    return;
+  }
+
+  // number of entries expected within the target latency
+  auto expected = static_cast<size_t>(m_maxAge.count() / m_avgInterval);
+  m_targetCount = std::clamp(expected, m_minCount, m_maxCount);
+}
+
+} // util
+} // mguard
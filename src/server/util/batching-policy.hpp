@@ -0,0 +1,126 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MGUARD_UTIL_BATCHING_POLICY_HPP
+#define MGUARD_UTIL_BATCHING_POLICY_HPP
+
+#include <ndn-cxx/util/time.hpp>
+
+namespace mguard {
+namespace util {
+
+/*
+  Decides when the manifest of a stream should be published.
+
+  A batch is flushed when it reaches maxCount entries or maxBytes (encoded names), and it
+  is flushed by the publisher's timer at the latest getFlushDelay() after the last entry,
+  i.e. after idleTime without a new entry or once its first entry is maxAge old.
+
+  In adaptive mode, the count limit follows the arrival rate of the stream (EWMA of the
+  inter-arrival time): the batch is sized to the number of entries expected within the
+  target latency, between minCount and maxCount, and maxAge is the target latency.
+*/
+class BatchingPolicy
+{
+public:
+  enum class Mode { FIXED, ADAPTIVE };
+
+  BatchingPolicy(size_t maxCount, size_t maxBytes, ndn::time::milliseconds maxAge,
+                 ndn::time::milliseconds idleTime);
+
+  static BatchingPolicy
+  makeAdaptive(ndn::time::milliseconds targetLatency, size_t minCount, size_t maxCount,
+               size_t maxBytes, ndn::time::milliseconds idleTime);
+
+  // policy built from the defaults in common.hpp
+  static BatchingPolicy
+  makeDefault();
+
+  /**
+   * @brief Account a new entry of the batch
+   * @param entryBytes encoded size of the entry
+   * @return true if the batch has to be published now
+  */
+  bool
+  onAppend(size_t entryBytes, const ndn::time::steady_clock::time_point& now = ndn::time::steady_clock::now());
+
+  /**
+   * @brief Delay after which the current batch has to be published if nothing else is added
+  */
+  ndn::time::milliseconds
+  getFlushDelay(const ndn::time::steady_clock::time_point& now = ndn::time::steady_clock::now()) const;
+
+  // reset the batch once it is published
+  void
+  onFlush();
+
+  Mode
+  getMode() const
+  {
+    return m_mode;
+  }
+
+  size_t
+  getBatchCount() const
+  {
+    return m_count;
+  }
+
+  size_t
+  getBatchBytes() const
+  {
+    return m_bytes;
+  }
+
+  // current count limit, fixed or derived from the arrival rate
+  size_t
+  getTargetCount() const
+  {
+    return m_targetCount;
+  }
+
+  // measured arrival rate in entries per second, 0 if not known yet
+  double
+  getArrivalRate() const;
+
+private:
+  void
+  updateArrivalRate(const ndn::time::steady_clock::time_point& now);
+
+private:
+  Mode m_mode = Mode::FIXED;
+  size_t m_minCount;
+  size_t m_maxCount;
+  size_t m_maxBytes;
+  ndn::time::milliseconds m_maxAge;
+  ndn::time::milliseconds m_idleTime;
+
+  size_t m_targetCount;
+  size_t m_count = 0;
+  size_t m_bytes = 0;
+  ndn::time::steady_clock::time_point m_batchStart;
+  ndn::time::steady_clock::time_point m_lastArrival;
+  bool m_hasArrival = false;
+  double m_avgInterval = 0; // milliseconds
+};
+
+} // util
+} // mguard
+
+#endif // MGUARD_UTIL_BATCHING_POLICY_HPP
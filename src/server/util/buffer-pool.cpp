@@ -0,0 +1,61 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "buffer-pool.hpp"
+
+#include <ndn-cxx/util/logger.hpp>
+
+namespace mguard {
+namespace util {
+
+NDN_LOG_INIT(mguard.util.BufferPool);
+
+BufferPool::BufferPool(size_t maxBuffers)
+  : m_maxBuffers(maxBuffers)
+{
+  m_buffers.reserve(m_maxBuffers);
+}
+
+std::shared_ptr<ndn::Buffer>
+BufferPool::acquire(const uint8_t* begin, const uint8_t* end)
+{
+  // buffers are usually released in the order they were handed out
+  for (size_t i = 0; i < m_buffers.size(); ++i) {
+    auto& buffer = m_buffers[(m_next + i) % m_buffers.size()];
+    if (buffer.use_count() == 1) {
+      m_next = (m_next + i + 1) % m_buffers.size();
+      buffer->assign(begin, end); // keeps the capacity
+      ++m_nReused;
+      return buffer;
+    }
+  }
+
+  ++m_nAllocated;
+  auto buffer = std::make_shared<ndn::Buffer>(begin, end);
+  if (m_buffers.size() < m_maxBuffers) {
+    m_buffers.push_back(buffer);
+  }
+  else {
+    NDN_LOG_TRACE("All " << m_buffers.size() << " pooled buffers are in use");
+  }
+  return buffer;
+}
+
+} // util
+} // mguard
@@ -0,0 +1,84 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MGUARD_UTIL_BUFFER_POOL_HPP
+#define MGUARD_UTIL_BUFFER_POOL_HPP
+
+#include <ndn-cxx/encoding/buffer.hpp>
+
+#include <boost/noncopyable.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace mguard {
+namespace util {
+
+/*
+  Pool of reusable byte buffers for content that only lives until its packet is encoded, e.g.
+  the content of a manifest segment, which is copied into the wire encoding when the segment is
+  signed (the signed packet no longer refers to it).
+
+  A buffer is handed out again once nothing else holds it (its use count is back to one), a Block
+  still referring to a buffer never sees it change. At most maxBuffers are kept, beyond that
+  buffers are allocated as usual and freed by their last user.
+*/
+class BufferPool : boost::noncopyable
+{
+public:
+  explicit
+  BufferPool(size_t maxBuffers);
+
+  // a buffer holding a copy of [begin, end)
+  std::shared_ptr<ndn::Buffer>
+  acquire(const uint8_t* begin, const uint8_t* end);
+
+  // number of pooled buffers
+  size_t
+  size() const
+  {
+    return m_buffers.size();
+  }
+
+  // number of acquisitions served by a pooled buffer
+  uint64_t
+  getReuseCount() const
+  {
+    return m_nReused;
+  }
+
+  // number of acquisitions that allocated a new buffer
+  uint64_t
+  getAllocationCount() const
+  {
+    return m_nAllocated;
+  }
+
+private:
+  size_t m_maxBuffers;
+  std::vector<std::shared_ptr<ndn::Buffer>> m_buffers;
+  size_t m_next = 0; // where the search for a free buffer starts
+  uint64_t m_nReused = 0;
+  uint64_t m_nAllocated = 0;
+};
+
+} // util
+} // mguard
+
+#endif // MGUARD_UTIL_BUFFER_POOL_HPP
@@ -0,0 +1,217 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "checkpoint.hpp"
+#include "record-io.hpp"
+#include "../../common.hpp"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
+#include <ndn-cxx/util/io.hpp>
+#include <ndn-cxx/util/logger.hpp>
+
+#include <boost/filesystem/path.hpp>
+
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <unistd.h>
+
+namespace mguard {
+namespace util {
+
+NDN_LOG_INIT(mguard.util.Checkpoint);
+
+ndn::Block
+StreamCheckpoint::wireEncode() const
+{
+  ndn::EncodingBuffer encoder;
+  size_t totalLength = 0;
+
+  if (!pendingEntries.empty()) {
+    size_t pendingLength = 0;
+    for (auto it = pendingEntries.rbegin(); it != pendingEntries.rend(); ++it) {
+      pendingLength += it->wireEncode(encoder);
+    }
+    pendingLength += encoder.prependVarNumber(pendingLength);
+    pendingLength += encoder.prependVarNumber(mguard::tlv::mGuardCheckpointPending);
+    totalLength += pendingLength;
+  }
+  if (openIndex) {
+    totalLength += ndn::encoding::prependBlock(encoder, openIndex->wireEncode());
+  }
+  if (lastPublished) {
+    totalLength += ndn::encoding::prependNonNegativeIntegerBlock(encoder, mguard::tlv::mGuardCheckpointLastPublished,
+                                                                 ndn::time::toUnixTimestamp(*lastPublished).count());
+  }
+  totalLength += ndn::encoding::prependNonNegativeIntegerBlock(encoder, mguard::tlv::mGuardCheckpointIndexSeq, indexSeq);
+  totalLength += ndn::encoding::prependNonNegativeIntegerBlock(encoder, mguard::tlv::mGuardCheckpointManifestSeq, manifestSeq);
+  totalLength += streamName.wireEncode(encoder);
+  encoder.prependVarNumber(totalLength);
+  encoder.prependVarNumber(mguard::tlv::mGuardCheckpointStream);
+  return encoder.block();
+}
+
+void
+StreamCheckpoint::wireDecode(const ndn::Block& wire)
+{
+  if (wire.type() != mguard::tlv::mGuardCheckpointStream)
+    NDN_THROW(ndn::tlv::Error("Expected StreamCheckpoint, but TLV has type " + ndn::to_string(wire.type())));
+
+  wire.parse();
+  auto it = wire.elements_begin();
+  if (it == wire.elements_end() || it->type() != ndn::tlv::Name)
+    NDN_THROW(ndn::tlv::Error("StreamCheckpoint is missing the stream name"));
+  streamName.wireDecode(*it++);
+
+  if (it == wire.elements_end() || it->type() != mguard::tlv::mGuardCheckpointManifestSeq)
+    NDN_THROW(ndn::tlv::Error("StreamCheckpoint is missing the manifest sequence number"));
+  manifestSeq = ndn::encoding::readNonNegativeInteger(*it++);
+
+  if (it == wire.elements_end() || it->type() != mguard::tlv::mGuardCheckpointIndexSeq)
+    NDN_THROW(ndn::tlv::Error("StreamCheckpoint is missing the index sequence number"));
+  indexSeq = ndn::encoding::readNonNegativeInteger(*it++);
+
+  lastPublished.reset();
+  if (it != wire.elements_end() && it->type() == mguard::tlv::mGuardCheckpointLastPublished) {
+    lastPublished = ndn::time::fromUnixTimestamp(ndn::time::milliseconds(ndn::encoding::readNonNegativeInteger(*it++)));
+  }
+
+  openIndex.reset();
+  if (it != wire.elements_end() && it->type() == mguard::tlv::mGuardManifestIndex) {
+    openIndex.emplace();
+    openIndex->wireDecode(*it++);
+  }
+
+  pendingEntries.clear();
+  if (it != wire.elements_end() && it->type() == mguard::tlv::mGuardCheckpointPending) {
+    it->parse();
+    for (const auto& entry : it->elements()) {
+      pendingEntries.emplace_back(entry);
+    }
+  }
+}
+
+Checkpoint::Checkpoint(boost::asio::io_service& io, const std::string& path, const StateProvider& provider)
+: m_scheduler(io)
+, m_path(path)
+, m_provider(provider)
+{
+}
+
+std::vector<StreamCheckpoint>
+Checkpoint::load() const
+{
+  std::ifstream is(m_path, std::ios::binary);
+  if (!is.is_open()) {
+    NDN_LOG_INFO("No checkpoint at: " << m_path << ", starting fresh");
+    return {};
+  }
+
+  std::vector<StreamCheckpoint> streams;
+  try {
+    auto buffer = ndn::io::loadBuffer(is, ndn::io::NO_ENCODING);
+    ndn::Block wire(buffer);
+    if (wire.type() != mguard::tlv::mGuardCheckpoint)
+      NDN_THROW(ndn::tlv::Error("Expected Checkpoint, but TLV has type " + ndn::to_string(wire.type())));
+
+    wire.parse();
+    for (const auto& element : wire.elements()) {
+      streams.emplace_back();
+      streams.back().wireDecode(element);
+    }
+  }
+  catch (const std::exception& e) {
+    NDN_LOG_ERROR("Invalid checkpoint at: " << m_path << ", starting fresh: " << e.what());
+    return {};
+  }
+
+  NDN_LOG_INFO("Loaded checkpoint of " << streams.size() << " streams from: " << m_path);
+  return streams;
+}
+
+void
+Checkpoint::save()
+{
+  m_isSavePending = false;
+  m_saveEvent.cancel();
+
+  ndn::EncodingBuffer encoder;
+  size_t totalLength = 0;
+  auto streams = m_provider();
+  for (auto it = streams.rbegin(); it != streams.rend(); ++it) {
+    totalLength += ndn::encoding::prependBlock(encoder, it->wireEncode());
+  }
+  encoder.prependVarNumber(totalLength);
+  encoder.prependVarNumber(mguard::tlv::mGuardCheckpoint);
+
+  // neither a process crash nor a power loss can leave a partial checkpoint behind,
+  // the temporary file is on disk before it replaces the checkpoint
+  auto tempPath = m_path + ".tmp";
+  int fd = ::open(tempPath.data(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    NDN_LOG_ERROR("Failed to open checkpoint: " << tempPath << ": " << std::strerror(errno));
+    return;
+  }
+  try {
+    writeFully<std::runtime_error>(fd, encoder.buf(), encoder.size(), 0);
+    if (::fsync(fd) != 0)
+      NDN_THROW(std::runtime_error("Failed to sync: " + std::string(std::strerror(errno))));
+  }
+  catch (const std::exception& e) {
+    NDN_LOG_ERROR("Failed to write checkpoint: " << tempPath << ": " << e.what());
+    ::close(fd);
+    return;
+  }
+  ::close(fd);
+  if (std::rename(tempPath.data(), m_path.data()) != 0) {
+    NDN_LOG_ERROR("Failed to replace checkpoint: " << m_path);
+    return;
+  }
+
+  // the rename is only durable once the directory entry is on disk
+  auto directory = boost::filesystem::path(m_path).parent_path();
+  if (directory.empty())
+    directory = ".";
+  int dirFd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (dirFd < 0 || ::fsync(dirFd) != 0)
+    NDN_LOG_ERROR("Failed to sync directory: " << directory << ": " << std::strerror(errno));
+  if (dirFd >= 0)
+    ::close(dirFd);
+}
+
+void
+Checkpoint::flush()
+{
+  if (m_isSavePending)
+    save();
+}
+
+void
+Checkpoint::saveLater()
+{
+  if (m_isSavePending)
+    return;
+
+  m_isSavePending = true;
+  m_saveEvent = m_scheduler.schedule(CHECKPOINT_SAVE_INTERVAL, [this] { save(); });
+}
+
+} // util
+} // mguard
@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MGUARD_UTIL_CHECKPOINT_HPP
+#define MGUARD_UTIL_CHECKPOINT_HPP
+
+#include "../../manifest.hpp"
+
+#include <ndn-cxx/encoding/block.hpp>
+#include <ndn-cxx/name.hpp>
+#include <ndn-cxx/util/scheduler.hpp>
+#include <ndn-cxx/util/time.hpp>
+
+#include <boost/asio/io_service.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace mguard {
+namespace util {
+
+/*
+  Producer state of a stream that has to survive a restart.
+
+  Checkpoint = mGuardCheckpoint TLV-LENGTH *StreamCheckpoint
+  StreamCheckpoint = mGuardCheckpointStream TLV-LENGTH
+                       Name ; stream
+                       mGuardCheckpointManifestSeq
+                       mGuardCheckpointIndexSeq
+                       [mGuardCheckpointLastPublished] ; unix timestamp (ms)
+                       [mGuardManifestIndex] ; open index bucket
+                       [mGuardCheckpointPending] ; *Name, entries of the next manifest
+*/
+struct StreamCheckpoint
+{
+  ndn::Name streamName;
+  uint64_t manifestSeq = 0; // latest sync sequence number of <stream>/MANIFEST
+  uint64_t indexSeq = 0;    // latest sync sequence number of <stream>/MANIFEST/INDEX
+  std::optional<ndn::time::system_clock::time_point> lastPublished;
+  std::optional<manifest::ManifestIndex> openIndex;
+  std::vector<ndn::Name> pendingEntries;
+
+  ndn::Block
+  wireEncode() const;
+
+  /**
+   * @throw ndn::tlv::Error if the block is not a valid StreamCheckpoint
+  */
+  void
+  wireDecode(const ndn::Block& wire);
+};
+
+/*
+  Checkpoint file of the producer.
+
+  The state is taken from the provider and written to a temporary file that is renamed over the
+  checkpoint, a crash leaves either the old or the new checkpoint. save() writes right away,
+  saveLater() marks the state as changed and coalesces all changes into one write at most
+  CHECKPOINT_SAVE_INTERVAL later (e.g. the rows added to the pending manifest entries). A
+  published sync sequence number must be in the checkpoint before consumers can see it, flush()
+  writes the pending update right before the sync update goes out, so the sequence numbers cost
+  one write per sync update rather than one per change.
+*/
+class Checkpoint : boost::noncopyable
+{
+public:
+  using StateProvider = std::function<std::vector<StreamCheckpoint>()>;
+
+  Checkpoint(boost::asio::io_service& io, const std::string& path, const StateProvider& provider);
+
+  /**
+   * @brief Read the checkpoint of the last run
+   * @return state of the streams, empty if there is no (valid) checkpoint
+  */
+  std::vector<StreamCheckpoint>
+  load() const;
+
+  void
+  save();
+
+  /**
+   * @brief Write the state within CHECKPOINT_SAVE_INTERVAL, unless flush() comes first
+  */
+  void
+  saveLater();
+
+  /**
+   * @brief Write the update scheduled by saveLater() now, if any
+  */
+  void
+  flush();
+
+  const std::string&
+  getPath() const
+  {
+    return m_path;
+  }
+
+private:
+  ndn::Scheduler m_scheduler;
+  std::string m_path;
+  StateProvider m_provider;
+  bool m_isSavePending = false;
+  ndn::scheduler::ScopedEventId m_saveEvent;
+};
+
+} // util
+} // mguard
+
+#endif // MGUARD_UTIL_CHECKPOINT_HPP
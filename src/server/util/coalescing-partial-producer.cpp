@@ -0,0 +1,39 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "coalescing-partial-producer.hpp"
+
+namespace mguard {
+namespace util {
+
+void
+CoalescingPartialProducer::publishNames(const std::map<ndn::Name, uint64_t>& seqNos)
+{
+  for (const auto& [prefix, seq] : seqNos) {
+    if (getSeqNo(prefix))
+      updateSeqNo(prefix, seq);
+  }
+  // the sequence numbers are already set, this only answers the sync interests still pending
+  for (const auto& [prefix, seq] : seqNos) {
+    publishName(prefix, seq);
+  }
+}
+
+} // util
+} // mguard
@@ -0,0 +1,50 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MGUARD_UTIL_COALESCING_PARTIAL_PRODUCER_HPP
+#define MGUARD_UTIL_COALESCING_PARTIAL_PRODUCER_HPP
+
+#include <PSync/partial-producer.hpp>
+
+#include <map>
+
+namespace mguard {
+namespace util {
+
+/*
+  Partial producer that publishes the sequence numbers of several prefixes as one update.
+
+  publishName() of PartialProducer answers the pending sync interests right away, so publishing
+  N prefixes one by one sends a consumer subscribed to all of them a reply for the first one
+  and leaves the rest to its next sync interest. Here all the sequence numbers go into the IBF
+  first, each pending sync interest is then answered once with the complete difference.
+*/
+class CoalescingPartialProducer : public psync::PartialProducer
+{
+public:
+  using psync::PartialProducer::PartialProducer;
+
+  void
+  publishNames(const std::map<ndn::Name, uint64_t>& seqNos);
+};
+
+} // util
+} // mguard
+
+#endif // MGUARD_UTIL_COALESCING_PARTIAL_PRODUCER_HPP
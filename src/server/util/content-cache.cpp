@@ -0,0 +1,157 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "content-cache.hpp"
+
+#include <ndn-cxx/util/logger.hpp>
+
+namespace mguard {
+namespace util {
+
+NDN_LOG_INIT(mguard.util.ContentCache);
+
+ContentCache::ContentCache(ndn::Scheduler& scheduler, size_t capacity,
+                           ndn::time::milliseconds ttl, ndn::time::milliseconds storedGrace)
+: m_scheduler(scheduler)
+, m_capacity(capacity)
+, m_ttl(ttl)
+, m_storedGrace(storedGrace)
+{
+}
+
+void
+ContentCache::insert(const ndn::Data& data)
+{
+  insert(std::make_shared<const ndn::Data>(data));
+}
+
+void
+ContentCache::insert(std::shared_ptr<const ndn::Data> data)
+{
+  auto expiry = ndn::time::steady_clock::now() + m_ttl;
+  size_t size = data->wireEncode().size();
+
+  auto it = m_table.find(data->getName());
+  if (it != m_table.end()) {
+    // e.g. the CK data, which is reused for all data encrypted with the same attributes
+    m_nBytes = m_nBytes - it->second.size + size;
+    it->second.data = std::move(data);
+    it->second.size = size;
+    it->second.expiry = expiry;
+    m_lru.splice(m_lru.begin(), m_lru, it->second.lruPosition);
+  }
+  else {
+    m_lru.push_front(data->getName());
+    m_table.emplace(m_lru.front(), Entry{std::move(data), size, expiry, m_lru.begin()});
+    m_nBytes += size;
+  }
+
+  while (m_nBytes > m_capacity && !m_lru.empty()) {
+    NDN_LOG_TRACE("Cache is full, evicting: " << m_lru.back());
+    erase(m_table.find(m_lru.back()));
+  }
+
+  if (!m_table.empty() && !m_isSweepScheduled)
+    scheduleSweep();
+}
+
+ContentCache::Table::iterator
+ContentCache::lookup(const ndn::Interest& interest)
+{
+  const auto& name = interest.getName();
+  if (!name.empty() && name.get(-1).isImplicitSha256Digest()) {
+    auto it = m_table.find(name.getPrefix(-1));
+    return (it != m_table.end() && it->second.data->getFullName() == name) ? it : m_table.end();
+  }
+
+  auto it = m_table.find(name);
+  if (it != m_table.end() || !interest.getCanBePrefix())
+    return it;
+
+  // first (canonical order) packet under the prefix
+  it = m_table.lower_bound(name);
+  return (it != m_table.end() && name.isPrefixOf(it->first)) ? it : m_table.end();
+}
+
+std::shared_ptr<const ndn::Data>
+ContentCache::find(const ndn::Interest& interest)
+{
+  auto it = lookup(interest);
+  if (it != m_table.end() && it->second.expiry <= ndn::time::steady_clock::now()) {
+    erase(it);
+    it = m_table.end();
+  }
+
+  if (it == m_table.end() ||
+      (interest.getMustBeFresh() && it->second.data->getFreshnessPeriod() <= ndn::time::milliseconds::zero())) {
+    ++m_nMisses;
+    return nullptr;
+  }
+
+  ++m_nHits;
+  m_lru.splice(m_lru.begin(), m_lru, it->second.lruPosition);
+  return it->second.data;
+}
+
+void
+ContentCache::markStored(const ndn::Name& name)
+{
+  auto it = m_table.find(name);
+  if (it == m_table.end())
+    return;
+
+  it->second.expiry = std::min(it->second.expiry, ndn::time::steady_clock::now() + m_storedGrace);
+}
+
+void
+ContentCache::erase(Table::iterator it)
+{
+  m_nBytes -= it->second.size;
+  m_lru.erase(it->second.lruPosition);
+  m_table.erase(it);
+}
+
+void
+ContentCache::scheduleSweep()
+{
+  // expired entries are never served, sweeping only gives the memory back
+  m_isSweepScheduled = true;
+  m_sweepEvent = m_scheduler.schedule(m_storedGrace, [this] {
+    m_isSweepScheduled = false;
+    sweep();
+  });
+}
+
+void
+ContentCache::sweep()
+{
+  auto now = ndn::time::steady_clock::now();
+  for (auto it = m_table.begin(); it != m_table.end();) {
+    auto current = it++;
+    if (current->second.expiry <= now)
+      erase(current);
+  }
+
+  NDN_LOG_TRACE("Cache size after sweep: " << m_table.size() << " packets, " << m_nBytes << " bytes");
+  if (!m_table.empty())
+    scheduleSweep();
+}
+
+} // util
+} // mguard
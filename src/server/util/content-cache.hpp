@@ -0,0 +1,147 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MGUARD_UTIL_CONTENT_CACHE_HPP
+#define MGUARD_UTIL_CONTENT_CACHE_HPP
+
+#include <ndn-cxx/data.hpp>
+#include <ndn-cxx/interest.hpp>
+#include <ndn-cxx/util/scheduler.hpp>
+
+#include <list>
+#include <map>
+#include <memory>
+
+namespace mguard {
+namespace util {
+
+/*
+  In-memory content store of the producer.
+
+  Packets are written to the repo asynchronously, a consumer reacting to a sync update can ask
+  for a packet before the repo has stored it. The publisher keeps every freshly produced packet
+  (data, CK and manifest) here and answers Interests from it. An entry expires after the TTL, or
+  a short grace period after the repo write completed (in-flight Interests are still answered).
+  The cache is bounded by the total wire size of the packets, least recently used ones are
+  evicted first. Misses are left to the repo.
+*/
+class ContentCache
+{
+public:
+  /**
+   * @param capacity maximum total wire size of the cached packets, in bytes
+   * @param ttl time a packet is kept at most
+   * @param storedGrace time a packet is kept after it is stored in the repo
+  */
+  ContentCache(ndn::Scheduler& scheduler, size_t capacity,
+               ndn::time::milliseconds ttl, ndn::time::milliseconds storedGrace);
+
+  /**
+   * @brief Add a packet, or refresh it if a packet with the same name is cached
+  */
+  void
+  insert(const ndn::Data& data);
+
+  /**
+   * @brief Add a packet without copying it, the packet must not be modified afterwards
+  */
+  void
+  insert(std::shared_ptr<const ndn::Data> data);
+
+  /**
+   * @brief Find a packet satisfying the interest (exact name, full name with implicit
+   *  digest or prefix match with CanBePrefix)
+   * @return the packet or nullptr
+  */
+  std::shared_ptr<const ndn::Data>
+  find(const ndn::Interest& interest);
+
+  /**
+   * @brief The repo confirmed storage of the packet, it is only kept for the grace period
+  */
+  void
+  markStored(const ndn::Name& name);
+
+  size_t
+  size() const
+  {
+    return m_table.size();
+  }
+
+  // total wire size of the cached packets
+  size_t
+  getBytes() const
+  {
+    return m_nBytes;
+  }
+
+  uint64_t
+  getHitCount() const
+  {
+    return m_nHits;
+  }
+
+  uint64_t
+  getMissCount() const
+  {
+    return m_nMisses;
+  }
+
+private:
+  struct Entry
+  {
+    std::shared_ptr<const ndn::Data> data;
+    size_t size;
+    ndn::time::steady_clock::time_point expiry;
+    std::list<ndn::Name>::iterator lruPosition;
+  };
+  using Table = std::map<ndn::Name, Entry>;
+
+  Table::iterator
+  lookup(const ndn::Interest& interest);
+
+  void
+  erase(Table::iterator it);
+
+  void
+  scheduleSweep();
+
+  // drop expired entries
+  void
+  sweep();
+
+private:
+  ndn::Scheduler& m_scheduler;
+  size_t m_capacity;
+  ndn::time::milliseconds m_ttl;
+  ndn::time::milliseconds m_storedGrace;
+
+  Table m_table; // ordered, for CanBePrefix lookups
+  std::list<ndn::Name> m_lru; // most recently used first
+  size_t m_nBytes = 0;
+  uint64_t m_nHits = 0;
+  uint64_t m_nMisses = 0;
+  ndn::scheduler::ScopedEventId m_sweepEvent;
+  bool m_isSweepScheduled = false;
+};
+
+} // util
+} // mguard
+
+#endif // MGUARD_UTIL_CONTENT_CACHE_HPP
@@ -19,6 +19,8 @@
 
 #include "database.hpp"
 
+#include <ndn-cxx/util/time.hpp>
+
 NDN_LOG_INIT(mguard.util.database);
 
 namespace mguard {
@@ -39,7 +41,8 @@ DataBase::DataBase(const std::string& databaseName)
                       end integer not null, \
                       semantic text not null, \
                       user text not null, \
-                      version text);";
+                      version text, \
+                      inserted integer not null);";
   
   if (!runQuery(table)) 
   {
@@ -181,8 +184,10 @@ DataBase::insertRows(const std::vector<std::string>& dataSet)
     return;
   }
   
-  std::string query = "INSERT INTO lookup (start, end, semantic, user, version) VALUES";
+  std::string query = "INSERT INTO lookup (start, end, semantic, user, version, inserted) VALUES";
   std::string value = "";
+  // wall clock, rows expire by the time they were inserted (not their data time)
+  auto inserted = std::to_string(ndn::time::toUnixTimestamp(ndn::time::system_clock::now()).count());
   // for (auto& row : dataSet)
   for (auto it = dataSet.begin(); it != dataSet.end(); ++it)
   {
@@ -199,7 +204,8 @@ DataBase::insertRows(const std::vector<std::string>& dataSet)
       value += "\""+ pRow[1] +"\"" + ","; // end time
       value += "\""+ pRow[2] +"\"" + ","; // semantic location
       value += "\""+ pRow[3] +"\"" + ","; // user
-      value += "\""+ pRow[4] +"\""; // version
+      value += "\""+ pRow[4] +"\"" + ","; // version
+      value += inserted; // insertion time (unix ms)
       value += ")";
       if (!(std::next(it) == dataSet.end()))
         value += ",";
@@ -223,5 +229,24 @@ DataBase::insertRows(const std::vector<std::string>& dataSet)
   closeDataBase();
 }
 
+void
+DataBase::deleteRows(const std::string& condition)
+{
+  if (!openDataBase()) {
+    NDN_LOG_INFO("Couldn't open database");
+    return;
+  }
+
+  std::string query = "DELETE FROM lookup WHERE " + condition + ";";
+  NDN_LOG_TRACE("Delete query: " << query);
+
+  if (runQuery(query))
+    NDN_LOG_DEBUG("Deleted " << sqlite3_changes(m_db) << " rows");
+  else
+    NDN_LOG_DEBUG("Failed to delete the rows");
+
+  closeDataBase();
+}
+
 } // db
-} // mguard
\ No newline at end of file
+} // mguard
@@ -72,9 +72,12 @@ public:
   void
   insertRows(const std::vector<std::string>& dataSet);
 
-  // not implemented??
+  /*
+    Delete the lookup rows matching the condition (where clause), e.g. "inserted < 1567296000000"
+    (insertion time in unix ms)
+  */
   void
-  deleteRows(std::string deleteQuery);
+  deleteRows(const std::string& condition);
 
   bool
   runQuery(const std::string& query);
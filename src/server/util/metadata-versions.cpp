@@ -0,0 +1,56 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "metadata-versions.hpp"
+
+#include <ndn-cxx/util/sha256.hpp>
+#include <ndn-cxx/util/time.hpp>
+
+#include <algorithm>
+
+namespace mguard {
+namespace util {
+
+std::optional<uint64_t>
+MetadataVersions::prepare(InternedId streamId, const std::string& metaData)
+{
+  if (streamId >= m_streams.size())
+    m_streams.resize(streamId + 1);
+  auto& entry = m_streams[streamId];
+
+  auto digest = ndn::util::Sha256::computeDigest({reinterpret_cast<const uint8_t*>(metaData.data()),
+                                                  metaData.size()});
+  if (entry.digest && *entry.digest == *digest)
+    return std::nullopt;
+
+  entry.pendingDigest = digest;
+  uint64_t now = ndn::time::toUnixTimestamp(ndn::time::system_clock::now()).count();
+  return std::max(now, entry.version + 1);
+}
+
+void
+MetadataVersions::commit(InternedId streamId, uint64_t version)
+{
+  auto& entry = m_streams.at(streamId);
+  entry.digest = std::move(entry.pendingDigest);
+  entry.version = version;
+}
+
+} // util
+} // mguard
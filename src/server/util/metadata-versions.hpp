@@ -0,0 +1,81 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MGUARD_UTIL_METADATA_VERSIONS_HPP
+#define MGUARD_UTIL_METADATA_VERSIONS_HPP
+
+#include "name-interner.hpp"
+
+#include <ndn-cxx/encoding/buffer.hpp>
+
+#include <boost/noncopyable.hpp>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace mguard {
+namespace util {
+
+/*
+  Versions of the metadata (batch header) of each stream.
+
+  The metadata rarely changes between batches, it is published as /<stream-name>/metadata/<version>
+  only if its SHA-256 differs from the last published one. The version is the unix timestamp (ms)
+  of the publication, but always greater than the last one, even if the clock steps back. Data
+  names carry the version of the metadata they were produced under.
+*/
+class MetadataVersions : boost::noncopyable
+{
+public:
+  /**
+   * @brief Check the metadata of a batch against the last published one of the stream
+   * @return version to publish it under, nullopt if it is unchanged
+  */
+  std::optional<uint64_t>
+  prepare(InternedId streamId, const std::string& metaData);
+
+  /**
+   * @brief The metadata of the last prepare() of the stream is published under the version
+  */
+  void
+  commit(InternedId streamId, uint64_t version);
+
+  // version of the last published metadata of the stream, 0 if none
+  uint64_t
+  getVersion(InternedId streamId) const
+  {
+    return streamId < m_streams.size() ? m_streams[streamId].version : 0;
+  }
+
+private:
+  struct Entry
+  {
+    ndn::ConstBufferPtr digest; // SHA-256 of the content, null until published
+    ndn::ConstBufferPtr pendingDigest; // of the last prepare()
+    uint64_t version = 0;
+  };
+
+  std::vector<Entry> m_streams; // by stream id
+};
+
+} // util
+} // mguard
+
+#endif // MGUARD_UTIL_METADATA_VERSIONS_HPP
@@ -0,0 +1,140 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MGUARD_UTIL_MPSC_QUEUE_HPP
+#define MGUARD_UTIL_MPSC_QUEUE_HPP
+
+#include <boost/noncopyable.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace mguard {
+namespace util {
+
+/*
+  Bounded lock-free queue for many producer threads and a single consumer.
+
+  A ring of cells, each with a sequence number telling whether it is free for the push at that
+  position or holds the value for the pop at that position (D. Vyukov's bounded queue). Producers
+  claim a position with a CAS on the tail and publish the value by advancing the sequence of the
+  cell, the consumer owns the head. Nothing is allocated after construction, a full queue is
+  reported to the producer instead of growing.
+
+  tryPop() must only be called from one thread at a time.
+*/
+template<typename T>
+class MpscQueue : boost::noncopyable
+{
+public:
+  // the capacity is rounded up to a power of two
+  explicit
+  MpscQueue(size_t capacity)
+  {
+    size_t size = 2;
+    while (size < capacity)
+      size <<= 1;
+
+    m_cells.reset(new Cell[size]);
+    m_mask = size - 1;
+    for (size_t i = 0; i < size; ++i)
+      m_cells[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  size_t
+  capacity() const
+  {
+    return m_mask + 1;
+  }
+
+  /**
+   * @brief Add a value, from any thread
+   * @return false if the queue is full, the value is left untouched then
+  */
+  bool
+  tryPush(T&& value)
+  {
+    auto pos = m_tail.load(std::memory_order_relaxed);
+    for (;;) {
+      auto& cell = m_cells[pos & m_mask];
+      auto seq = cell.sequence.load(std::memory_order_acquire);
+      auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        // the cell is free, claim the position
+        if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          cell.value = std::move(value);
+          cell.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      }
+      else if (diff < 0) {
+        // the cell still holds the value of the previous round
+        return false;
+      }
+      else {
+        // another producer claimed the position
+        pos = m_tail.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * @brief Take the oldest value, from the consumer thread only
+   * @return false if the queue is empty (or the oldest value is still being pushed)
+  */
+  bool
+  tryPop(T& value)
+  {
+    auto& cell = m_cells[m_head & m_mask];
+    auto seq = cell.sequence.load(std::memory_order_acquire);
+    if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(m_head + 1) < 0)
+      return false;
+
+    value = std::move(cell.value);
+    cell.value = T(); // don't keep the resources of the value until the cell is reused
+    cell.sequence.store(m_head + m_mask + 1, std::memory_order_release);
+    ++m_head;
+    return true;
+  }
+
+  // number of values in the queue, from the consumer thread, pushes in progress may be counted
+  size_t
+  size() const
+  {
+    return m_tail.load(std::memory_order_acquire) - m_head;
+  }
+
+private:
+  struct Cell
+  {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  std::unique_ptr<Cell[]> m_cells;
+  size_t m_mask;
+  alignas(64) std::atomic<size_t> m_tail{0}; // next position to push, shared by the producers
+  alignas(64) size_t m_head = 0; // next position to pop, owned by the consumer
+};
+
+} // util
+} // mguard
+
+#endif // MGUARD_UTIL_MPSC_QUEUE_HPP
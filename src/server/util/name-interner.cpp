@@ -0,0 +1,53 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "name-interner.hpp"
+
+#include <ndn-cxx/util/logger.hpp>
+
+namespace mguard {
+namespace util {
+
+NDN_LOG_INIT(mguard.util.NameInterner);
+
+InternedId
+NameInterner::intern(const ndn::Name& name)
+{
+  auto it = m_ids.find(name);
+  if (it != m_ids.end())
+    return it->second;
+
+  auto id = static_cast<InternedId>(m_entries.size());
+  m_entries.push_back(Entry{name, name.toUri(), name.wireEncode()});
+  m_ids.emplace(name, id);
+  NDN_LOG_TRACE("Interned: " << name << " as: " << id);
+  return id;
+}
+
+std::optional<InternedId>
+NameInterner::find(const ndn::Name& name) const
+{
+  auto it = m_ids.find(name);
+  if (it == m_ids.end())
+    return std::nullopt;
+  return it->second;
+}
+
+} // util
+} // mguard
@@ -0,0 +1,91 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MGUARD_UTIL_NAME_INTERNER_HPP
+#define MGUARD_UTIL_NAME_INTERNER_HPP
+
+#include <ndn-cxx/name.hpp>
+
+#include <boost/noncopyable.hpp>
+
+#include <deque>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace mguard {
+namespace util {
+
+using InternedId = uint32_t;
+
+/*
+  Maps names (stream names, attribute names) to dense ids, handed out in order from zero.
+
+  A name is parsed and encoded once when it is interned, the pipeline then carries the id and
+  gets the name, its URI and its wire encoding back in O(1). Ids can index plain vectors.
+*/
+class NameInterner : boost::noncopyable
+{
+public:
+  InternedId
+  intern(const ndn::Name& name);
+
+  std::optional<InternedId>
+  find(const ndn::Name& name) const;
+
+  const ndn::Name&
+  getName(InternedId id) const
+  {
+    return m_entries.at(id).name;
+  }
+
+  const std::string&
+  getUri(InternedId id) const
+  {
+    return m_entries.at(id).uri;
+  }
+
+  const ndn::Block&
+  getWire(InternedId id) const
+  {
+    return m_entries.at(id).wire;
+  }
+
+  size_t
+  size() const
+  {
+    return m_entries.size();
+  }
+
+private:
+  struct Entry
+  {
+    ndn::Name name;
+    std::string uri;
+    ndn::Block wire;
+  };
+
+  std::deque<Entry> m_entries; // by id, references stay valid while interning
+  std::unordered_map<ndn::Name, InternedId> m_ids;
+};
+
+} // util
+} // mguard
+
+#endif // MGUARD_UTIL_NAME_INTERNER_HPP
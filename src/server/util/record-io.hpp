@@ -0,0 +1,125 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MGUARD_UTIL_RECORD_IO_HPP
+#define MGUARD_UTIL_RECORD_IO_HPP
+
+#include <ndn-cxx/util/exception.hpp>
+
+#include <boost/crc.hpp>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+
+/*
+  Helpers for the length and CRC framed records of the on-disk logs (the spill journal and
+  the log store of the in-process repo)
+*/
+
+namespace mguard {
+namespace util {
+
+// little endian, independent of the host
+inline void
+putUint32(uint8_t* buf, uint32_t value)
+{
+  for (int i = 0; i < 4; ++i) {
+    buf[i] = static_cast<uint8_t>(value >> (8 * i));
+  }
+}
+
+inline uint32_t
+getUint32(const uint8_t* buf)
+{
+  uint32_t value = 0;
+  for (int i = 0; i < 4; ++i) {
+    value |= static_cast<uint32_t>(buf[i]) << (8 * i);
+  }
+  return value;
+}
+
+inline void
+putUint64(uint8_t* buf, uint64_t value)
+{
+  putUint32(buf, static_cast<uint32_t>(value));
+  putUint32(buf + 4, static_cast<uint32_t>(value >> 32));
+}
+
+inline uint64_t
+getUint64(const uint8_t* buf)
+{
+  return getUint32(buf) | (static_cast<uint64_t>(getUint32(buf + 4)) << 32);
+}
+
+inline uint32_t
+computeCrc(const uint8_t* data, size_t size)
+{
+  boost::crc_32_type crc;
+  crc.process_bytes(data, size);
+  return crc.checksum();
+}
+
+/**
+ * @brief Read exactly size bytes unless the end of file is reached
+ * @return the number of bytes read
+ * @throw E if reading fails
+*/
+template<typename E>
+size_t
+readFully(int fd, uint8_t* buf, size_t size, uint64_t offset)
+{
+  size_t nRead = 0;
+  while (nRead < size) {
+    auto n = ::pread(fd, buf + nRead, size - nRead, offset + nRead);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n < 0)
+      NDN_THROW(E("Failed to read: " + std::string(std::strerror(errno))));
+    if (n == 0)
+      break;
+    nRead += n;
+  }
+  return nRead;
+}
+
+/**
+ * @throw E if writing fails
+*/
+template<typename E>
+void
+writeFully(int fd, const uint8_t* buf, size_t size, uint64_t offset)
+{
+  size_t nWritten = 0;
+  while (nWritten < size) {
+    auto n = ::pwrite(fd, buf + nWritten, size - nWritten, offset + nWritten);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n < 0)
+      NDN_THROW(E("Failed to write: " + std::string(std::strerror(errno))));
+    nWritten += n;
+  }
+}
+
+} // util
+} // mguard
+
+#endif // MGUARD_UTIL_RECORD_IO_HPP
@@ -0,0 +1,334 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "repo-connection.hpp"
+#include "../../common.hpp"
+
+#include <ndn-cxx/util/logger.hpp>
+
+namespace mguard {
+namespace util {
+
+NDN_LOG_INIT(mguard.util.RepoConnection);
+
+// scatter/gather limit of a single write (IOV_MAX is 1024 on linux)
+const size_t MAX_GATHER_BUFFERS = 512;
+
+RepoConnection::RepoConnection(boost::asio::io_service& io, size_t maxBatchBytes,
+                               ndn::time::milliseconds maxDelay, const std::string& journalPath)
+: m_io(io)
+, m_resolv(io)
+, m_socket(io)
+, m_scheduler(io)
+, m_maxBatchBytes(maxBatchBytes)
+, m_maxDelay(maxDelay)
+, m_reconnectDelay(REPO_RECONNECT_MIN_DELAY)
+{
+  if (!journalPath.empty())
+    m_journal = std::make_unique<SpillJournal>(journalPath);
+}
+
+RepoConnection::~RepoConnection()
+{
+  *m_isAlive = false;
+  AsyncRepoError ignored;
+  m_resolv.cancel();
+  m_socket.close(ignored);
+}
+
+void
+RepoConnection::connect(const RepoEndpoint& endpoint, const AsyncConnectHandler& connectHandler)
+{
+  m_endpoint = endpoint;
+  m_connectHandler = connectHandler;
+  doConnect();
+}
+
+void
+RepoConnection::doConnect()
+{
+  m_isConnecting = true;
+  // resolve again on every attempt, the repo may have moved
+  bp::tcp::resolver::query query(m_endpoint.host, m_endpoint.port);
+  m_resolv.async_resolve(query, [this, isAlive = m_isAlive] (auto& err, auto& it) {
+    if (!*isAlive)
+      return;
+    NDN_LOG_TRACE("Resolvation status: " << err.message());
+    if (err) {
+      NDN_LOG_WARN("Repo endpoint " << m_endpoint.host << " cannot be resolved: " << err.message());
+      onDisconnected(err);
+      return;
+    }
+    m_socket.async_connect(*it, [this, isAlive] (auto& err) {
+      if (!*isAlive)
+        return;
+      NDN_LOG_DEBUG("Connnection status: " << err.message());
+      if (err)
+        onDisconnected(err);
+      else
+        onConnected();
+    });
+  });
+}
+
+void
+RepoConnection::onConnected()
+{
+  m_isConnecting = false;
+  m_isConnected = true;
+  m_reconnectDelay = REPO_RECONNECT_MIN_DELAY;
+  if (m_connectHandler) {
+    auto handler = std::move(m_connectHandler);
+    m_connectHandler = nullptr;
+    handler(AsyncRepoError());
+  }
+
+  // packets queued before the connection was up
+  flush();
+  if (m_journal && m_journal->hasNext()) {
+    NDN_LOG_INFO("Replaying " << m_journal->getPendingBytes() << " journaled bytes to the repo");
+    scheduleReplay();
+  }
+}
+
+void
+RepoConnection::onDisconnected(const AsyncRepoError& err)
+{
+  m_isConnecting = false;
+  m_isConnected = false;
+  AsyncRepoError ignored;
+  m_socket.close(ignored);
+
+  if (m_connectHandler) {
+    auto handler = std::move(m_connectHandler);
+    m_connectHandler = nullptr;
+    handler(err);
+  }
+
+  // spill the live packets, the replayed ones are still in the journal
+  auto pending = std::move(m_inFlight);
+  m_inFlight.clear();
+  pending.insert(pending.end(), std::make_move_iterator(m_queue.begin()),
+                 std::make_move_iterator(m_queue.end()));
+  m_queue.clear();
+  m_queueBytes = 0;
+  for (const auto& write : pending) {
+    if (!write.isReplay)
+      spill(write.wire, write.name, write.handler, err);
+  }
+  if (m_journal)
+    m_journal->rewind();
+
+  scheduleReconnect();
+}
+
+void
+RepoConnection::scheduleReconnect()
+{
+  if (m_isReconnectScheduled)
+    return;
+
+  NDN_LOG_DEBUG("Reconnecting to " << m_endpoint.host << ":" << m_endpoint.port
+                << " in " << m_reconnectDelay);
+  m_isReconnectScheduled = true;
+  m_reconnectEvent = m_scheduler.schedule(m_reconnectDelay, [this] {
+    m_isReconnectScheduled = false;
+    doConnect();
+  });
+  m_reconnectDelay = std::min(m_reconnectDelay * 2, REPO_RECONNECT_MAX_DELAY);
+}
+
+void
+RepoConnection::write(const ndn::Block& wire, const ndn::Name& name, const AsyncWriteHandler& writeHandler)
+{
+  // before the first attempt is done packets wait in the queue, after that for the reconnect
+  if (!m_isConnected && !m_connectHandler) {
+    auto err = boost::system::errc::make_error_code(boost::system::errc::not_connected);
+    spill(wire, name, writeHandler, err);
+    return;
+  }
+
+  m_queue.push_back(PendingWrite{wire, name, writeHandler});
+  m_queueBytes += wire.size();
+
+  if (m_isWriting) // goes with the next batch
+    return;
+
+  if (m_queueBytes >= m_maxBatchBytes)
+    flush();
+  else
+    scheduleFlush();
+}
+
+void
+RepoConnection::spill(const ndn::Block& wire, const ndn::Name& name, const AsyncWriteHandler& writeHandler,
+                      const AsyncRepoError& err)
+{
+  auto result = err;
+  if (m_journal) {
+    try {
+      m_journal->append(wire);
+      ++m_nSpilled;
+      scheduleJournalSync();
+      result = boost::system::errc::make_error_code(boost::system::errc::resource_unavailable_try_again);
+    }
+    catch (const SpillJournal::Error& e) {
+      NDN_LOG_ERROR("Failed to spill " << name << ": " << e.what());
+      ++m_nErrors;
+    }
+  }
+  else {
+    ++m_nErrors;
+  }
+
+  if (writeHandler)
+    m_io.post([name, writeHandler, result] { writeHandler(name, result); });
+}
+
+void
+RepoConnection::scheduleJournalSync()
+{
+  if (m_isSyncScheduled)
+    return;
+
+  m_isSyncScheduled = true;
+  m_syncEvent = m_scheduler.schedule(REPO_SYNC_INTERVAL, [this] {
+    m_isSyncScheduled = false;
+    m_journal->sync();
+  });
+}
+
+void
+RepoConnection::scheduleReplay()
+{
+  if (m_isReplayScheduled)
+    return;
+
+  m_isReplayScheduled = true;
+  m_replayEvent = m_scheduler.schedule(REPO_REPLAY_INTERVAL, [this] {
+    m_isReplayScheduled = false;
+    replay();
+  });
+}
+
+void
+RepoConnection::replay()
+{
+  if (!m_isConnected)
+    return;
+
+  size_t nBytes = 0;
+  while (m_queueBytes < m_maxBatchBytes && nBytes < REPO_REPLAY_BATCH_BYTES && m_journal->hasNext()) {
+    std::optional<ndn::Block> wire;
+    try {
+      wire = m_journal->next();
+    }
+    catch (const SpillJournal::Error& e) {
+      NDN_LOG_ERROR("Failed to replay the journal: " << e.what());
+      return;
+    }
+    nBytes += wire->size();
+    m_queueBytes += wire->size();
+    m_queue.push_back(PendingWrite{std::move(*wire), ndn::Name(), nullptr, true});
+  }
+
+  if (nBytes > 0 && !m_isWriting) {
+    if (m_queueBytes >= m_maxBatchBytes)
+      flush();
+    else
+      scheduleFlush();
+  }
+
+  if (m_journal->hasNext())
+    scheduleReplay();
+}
+
+void
+RepoConnection::scheduleFlush()
+{
+  if (m_isFlushScheduled)
+    return;
+
+  m_isFlushScheduled = true;
+  m_flushEvent = m_scheduler.schedule(m_maxDelay, [this] {
+    m_isFlushScheduled = false;
+    flush();
+  });
+}
+
+void
+RepoConnection::flush()
+{
+  if (m_isWriting || !m_isConnected || m_queue.empty())
+    return;
+
+  m_flushEvent.cancel();
+  m_isFlushScheduled = false;
+
+  std::vector<boost::asio::const_buffer> buffers;
+  size_t batchBytes = 0;
+  while (!m_queue.empty() && buffers.size() < MAX_GATHER_BUFFERS &&
+         (buffers.empty() || batchBytes + m_queue.front().wire.size() <= m_maxBatchBytes)) {
+    auto& pending = m_queue.front();
+    buffers.emplace_back(pending.wire.wire(), pending.wire.size());
+    batchBytes += pending.wire.size();
+    m_queueBytes -= pending.wire.size();
+    // moving the block keeps its buffer, the pointers above stay valid
+    m_inFlight.push_back(std::move(pending));
+    m_queue.pop_front();
+  }
+
+  NDN_LOG_TRACE("Writing " << buffers.size() << " packets, " << batchBytes << " bytes");
+  m_isWriting = true;
+  boost::asio::async_write(m_socket, buffers, [this, isAlive = m_isAlive] (const AsyncRepoError& err, size_t) {
+    if (*isAlive)
+      onWritten(err);
+  });
+}
+
+void
+RepoConnection::onWritten(const AsyncRepoError& err)
+{
+  m_isWriting = false;
+  if (err) {
+    NDN_LOG_ERROR("Failed to write to the repo: " << err.message());
+    onDisconnected(err);
+    return;
+  }
+
+  auto written = std::move(m_inFlight);
+  m_inFlight.clear();
+  for (const auto& pending : written) {
+    if (pending.isReplay) {
+      // replayed packets are written in journal order
+      m_journal->consume();
+      ++m_nReplayed;
+    }
+    else {
+      ++m_nWritten;
+      pending.handler(pending.name, err);
+    }
+  }
+
+  // packets queued meanwhile have waited long enough
+  flush();
+}
+
+} // util
+} // mguard
@@ -0,0 +1,242 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MGUARD_UTIL_REPO_CONNECTION_HPP
+#define MGUARD_UTIL_REPO_CONNECTION_HPP
+
+#include <boost/asio.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+#include "spill-journal.hpp"
+
+#include <ndn-cxx/encoding/block.hpp>
+#include <ndn-cxx/name.hpp>
+#include <ndn-cxx/util/scheduler.hpp>
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace mguard {
+namespace util {
+namespace bp = boost::asio::ip;
+using AsyncRepoError = boost::system::error_code;
+using AsyncConnectHandler = std::function<void(const AsyncRepoError&)>;
+using AsyncWriteHandler = std::function<void(const ndn::Name&, const AsyncRepoError&)>;
+
+struct RepoEndpoint
+{
+  std::string host;
+  std::string port;
+};
+
+/*
+  TCP connection to a repo with an ordered write queue.
+
+  Packets are written in the order they are queued, only one write is in flight at a time.
+  A write gathers the encoded packets of the queue (their own buffers, nothing is copied) up to
+  maxBatchBytes into one async_write, which also resumes partial writes. While a write is in
+  flight, new packets wait for the next batch; on an idle connection the queue is flushed once
+  it reaches maxBatchBytes or maxDelay after the first packet was queued. The handler of each
+  packet is called once its batch is written.
+
+  If the repo is unreachable or a write fails, the connection is retried with exponential backoff
+  (REPO_RECONNECT_MIN_DELAY doubling up to REPO_RECONNECT_MAX_DELAY) instead of giving up. With a
+  journal path, packets that can't be written meanwhile, including the failed batch and the queue,
+  are appended to a SpillJournal and their handler gets resource_unavailable_try_again. Once
+  connected again, the journal is replayed in order every REPO_REPLAY_INTERVAL, at most
+  REPO_REPLAY_BATCH_BYTES at a time and only while the live queue is below a batch, so live
+  packets are not starved (they may be written before older spilled ones).
+
+  The connection may be destroyed with a resolve, connect or write in flight, their handlers are
+  aborted and don't touch it anymore. Queued packets are dropped without calling their handler.
+*/
+class RepoConnection : boost::noncopyable
+{
+public:
+  /**
+   * @param journalPath spill journal file, packets are failed instead of spilled if empty
+   * @throw SpillJournal::Error if the journal can't be opened
+  */
+  RepoConnection(boost::asio::io_service& io, size_t maxBatchBytes, ndn::time::milliseconds maxDelay,
+                 const std::string& journalPath = "");
+
+  ~RepoConnection();
+
+  /**
+   * @brief Connect to the repo, connectHandler is called with the result of the first attempt
+   *  only, the connection keeps retrying in the background after that
+  */
+  void
+  connect(const RepoEndpoint& endpoint, const AsyncConnectHandler& connectHandler);
+
+  /**
+   * @brief Queue an encoded packet for writing
+   * @param wire encoded packet, its buffer is kept until the packet is written
+   * @param name packet name, given back to the handler
+  */
+  void
+  write(const ndn::Block& wire, const ndn::Name& name, const AsyncWriteHandler& writeHandler);
+
+  bool
+  isConnected() const
+  {
+    return m_isConnected;
+  }
+
+  const RepoEndpoint&
+  getEndpoint() const
+  {
+    return m_endpoint;
+  }
+
+  uint64_t
+  getWrittenCount() const
+  {
+    return m_nWritten;
+  }
+
+  // number of packets that failed to be written
+  uint64_t
+  getErrorCount() const
+  {
+    return m_nErrors;
+  }
+
+  // number of packets appended to the journal
+  uint64_t
+  getSpilledCount() const
+  {
+    return m_nSpilled;
+  }
+
+  // number of packets written from the journal
+  uint64_t
+  getReplayedCount() const
+  {
+    return m_nReplayed;
+  }
+
+  // bytes in the journal waiting to be replayed
+  uint64_t
+  getSpilledBytes() const
+  {
+    return m_journal ? m_journal->getPendingBytes() : 0;
+  }
+
+  // number of packets waiting to be written, including the batch in flight
+  size_t
+  getQueueSize() const
+  {
+    return m_queue.size() + m_inFlight.size();
+  }
+
+  // bytes waiting to be written, excluding the batch in flight
+  size_t
+  getQueueBytes() const
+  {
+    return m_queueBytes;
+  }
+
+private:
+  void
+  doConnect();
+
+  void
+  onConnected();
+
+  void
+  onDisconnected(const AsyncRepoError& err);
+
+  void
+  scheduleReconnect();
+
+  /**
+   * @brief Append the packet to the journal, or fail it if there is none
+  */
+  void
+  spill(const ndn::Block& wire, const ndn::Name& name, const AsyncWriteHandler& writeHandler,
+        const AsyncRepoError& err);
+
+  void
+  scheduleJournalSync();
+
+  // queue packets from the journal, if the live queue leaves room for them
+  void
+  replay();
+
+  void
+  scheduleReplay();
+
+  void
+  scheduleFlush();
+
+  // start writing the next batch, if no write is in flight
+  void
+  flush();
+
+  void
+  onWritten(const AsyncRepoError& err);
+
+private:
+  struct PendingWrite
+  {
+    ndn::Block wire;
+    ndn::Name name;
+    AsyncWriteHandler handler;
+    bool isReplay = false; // read from the journal, no handler
+  };
+
+  boost::asio::io_service& m_io;
+  bp::tcp::resolver m_resolv;
+  bp::tcp::socket m_socket;
+  ndn::Scheduler m_scheduler;
+  size_t m_maxBatchBytes;
+  ndn::time::milliseconds m_maxDelay;
+  RepoEndpoint m_endpoint;
+  AsyncConnectHandler m_connectHandler; // until the first attempt is done
+  std::unique_ptr<SpillJournal> m_journal;
+
+  std::deque<PendingWrite> m_queue;
+  std::vector<PendingWrite> m_inFlight;
+  size_t m_queueBytes = 0;
+  bool m_isConnected = false;
+  bool m_isWriting = false;
+  bool m_isConnecting = false;
+  bool m_isFlushScheduled = false;
+  bool m_isReconnectScheduled = false;
+  bool m_isReplayScheduled = false;
+  bool m_isSyncScheduled = false;
+  ndn::time::milliseconds m_reconnectDelay;
+  ndn::scheduler::ScopedEventId m_flushEvent;
+  ndn::scheduler::ScopedEventId m_reconnectEvent;
+  ndn::scheduler::ScopedEventId m_replayEvent;
+  ndn::scheduler::ScopedEventId m_syncEvent;
+  uint64_t m_nWritten = 0;
+  uint64_t m_nErrors = 0;
+  uint64_t m_nSpilled = 0;
+  uint64_t m_nReplayed = 0;
+  // shared with the handlers of the socket operations, which may run after the destruction
+  std::shared_ptr<bool> m_isAlive = std::make_shared<bool>(true);
+};
+
+} // util
+} // mguard
+
+#endif // MGUARD_UTIL_REPO_CONNECTION_HPP
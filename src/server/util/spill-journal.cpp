@@ -0,0 +1,151 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "spill-journal.hpp"
+#include "record-io.hpp"
+
+#include <ndn-cxx/util/logger.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace mguard {
+namespace util {
+
+NDN_LOG_INIT(mguard.util.SpillJournal);
+
+const size_t JOURNAL_HEADER_SIZE = 8;
+
+SpillJournal::SpillJournal(const std::string& path)
+: m_path(path)
+{
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(boost::filesystem::path(m_path).parent_path(), ec);
+
+  m_fd = ::open(m_path.data(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (m_fd < 0)
+    NDN_THROW(Error("Failed to open " + m_path + ": " + std::strerror(errno)));
+
+  // find the end of the valid records
+  uint8_t header[JOURNAL_HEADER_SIZE];
+  while (readFully<Error>(m_fd, header, JOURNAL_HEADER_SIZE, m_endOffset) == JOURNAL_HEADER_SIZE) {
+    uint32_t length = getUint32(header);
+    // a torn or garbage header may carry any length, check it before allocating
+    if (length == 0 || length > ndn::MAX_NDN_PACKET_SIZE) {
+      NDN_LOG_WARN("Invalid record length in " << m_path << " at: " << m_endOffset << ", truncating");
+      break;
+    }
+    ndn::Buffer buffer(length);
+    if (readFully<Error>(m_fd, buffer.data(), length, m_endOffset + JOURNAL_HEADER_SIZE) != length ||
+        computeCrc(buffer.data(), length) != getUint32(header + 4)) {
+      NDN_LOG_WARN("Torn record in " << m_path << " at: " << m_endOffset << ", truncating");
+      break;
+    }
+    m_endOffset += JOURNAL_HEADER_SIZE + length;
+  }
+
+  if (::ftruncate(m_fd, m_endOffset) != 0)
+    NDN_THROW(Error("Failed to truncate " + m_path + ": " + std::strerror(errno)));
+
+  if (m_endOffset > 0)
+    NDN_LOG_INFO("Journal " << m_path << " has " << m_endOffset << " bytes to replay");
+}
+
+SpillJournal::~SpillJournal()
+{
+  if (m_fd >= 0) {
+    ::fsync(m_fd);
+    ::close(m_fd);
+  }
+}
+
+void
+SpillJournal::append(const ndn::Block& wire)
+{
+  std::vector<uint8_t> record(JOURNAL_HEADER_SIZE + wire.size());
+  putUint32(record.data(), wire.size());
+  putUint32(record.data() + 4, computeCrc(wire.wire(), wire.size()));
+  std::copy(wire.begin(), wire.end(), record.begin() + JOURNAL_HEADER_SIZE);
+
+  writeFully<Error>(m_fd, record.data(), record.size(), m_endOffset);
+  m_endOffset += record.size();
+  m_hasUnsynced = true;
+}
+
+std::optional<ndn::Block>
+SpillJournal::next()
+{
+  if (m_nextOffset >= m_endOffset)
+    return std::nullopt;
+
+  uint8_t header[JOURNAL_HEADER_SIZE];
+  if (readFully<Error>(m_fd, header, JOURNAL_HEADER_SIZE, m_nextOffset) != JOURNAL_HEADER_SIZE)
+    NDN_THROW(Error("Failed to read from " + m_path));
+
+  uint32_t length = getUint32(header);
+  if (length == 0 || length > m_endOffset - m_nextOffset - JOURNAL_HEADER_SIZE)
+    NDN_THROW(Error("Invalid record length in " + m_path));
+  auto buffer = std::make_shared<ndn::Buffer>(length);
+  if (readFully<Error>(m_fd, buffer->data(), length, m_nextOffset + JOURNAL_HEADER_SIZE) != length)
+    NDN_THROW(Error("Failed to read from " + m_path));
+
+  m_handedOutSizes.push_back(JOURNAL_HEADER_SIZE + length);
+  m_nextOffset += JOURNAL_HEADER_SIZE + length;
+  return ndn::Block(std::move(buffer));
+}
+
+void
+SpillJournal::consume()
+{
+  if (m_handedOutSizes.empty())
+    return;
+
+  m_readOffset += m_handedOutSizes.front();
+  m_handedOutSizes.pop_front();
+
+  if (m_readOffset == m_endOffset) {
+    // everything is replayed, reclaim the space
+    NDN_LOG_DEBUG("Journal " << m_path << " is replayed");
+    if (::ftruncate(m_fd, 0) != 0)
+      NDN_LOG_ERROR("Failed to truncate " << m_path << ": " << std::strerror(errno));
+    m_readOffset = m_nextOffset = m_endOffset = 0;
+  }
+}
+
+void
+SpillJournal::rewind()
+{
+  m_nextOffset = m_readOffset;
+  m_handedOutSizes.clear();
+}
+
+void
+SpillJournal::sync()
+{
+  if (::fdatasync(m_fd) != 0)
+    NDN_LOG_ERROR("Failed to sync " << m_path << ": " << std::strerror(errno));
+  m_hasUnsynced = false;
+}
+
+} // util
+} // mguard
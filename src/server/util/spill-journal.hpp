@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MGUARD_UTIL_SPILL_JOURNAL_HPP
+#define MGUARD_UTIL_SPILL_JOURNAL_HPP
+
+#include <ndn-cxx/encoding/block.hpp>
+
+#include <boost/noncopyable.hpp>
+
+#include <deque>
+#include <optional>
+#include <string>
+
+namespace mguard {
+namespace util {
+
+/*
+  Append-only on-disk FIFO of encoded packets, holds packets for the repo while it is unreachable.
+
+  Records are [length (4) | crc32 (4) | wire]. Packets are read in order with next() and only
+  removed with consume() once the repo has them, rewind() goes back to the first packet not
+  consumed (e.g. after a failed write). Once everything is consumed the file is truncated.
+  Appends are made durable with sync(), which the owner calls in batches. On open, a torn tail
+  is truncated and all the records are pending again; packets that were consumed before a crash
+  may be replayed twice, which is harmless for the repo.
+*/
+class SpillJournal : boost::noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    using std::runtime_error::runtime_error;
+  };
+
+  /**
+   * @throw Error if the file can't be opened
+  */
+  explicit
+  SpillJournal(const std::string& path);
+
+  ~SpillJournal();
+
+  /**
+   * @throw Error if the write fails
+  */
+  void
+  append(const ndn::Block& wire);
+
+  /**
+   * @brief Read the next packet not handed out yet
+   * @return the packet, or nullopt if all the packets are handed out
+  */
+  std::optional<ndn::Block>
+  next();
+
+  /**
+   * @brief Remove the oldest packet handed out by next()
+  */
+  void
+  consume();
+
+  /**
+   * @brief Hand out the packets not consumed again
+  */
+  void
+  rewind();
+
+  // flush appended records to disk
+  void
+  sync();
+
+  // whether next() has a packet
+  bool
+  hasNext() const
+  {
+    return m_nextOffset < m_endOffset;
+  }
+
+  bool
+  empty() const
+  {
+    return m_readOffset == m_endOffset;
+  }
+
+  // bytes of the packets not consumed yet
+  uint64_t
+  getPendingBytes() const
+  {
+    return m_endOffset - m_readOffset;
+  }
+
+  bool
+  hasUnsynced() const
+  {
+    return m_hasUnsynced;
+  }
+
+private:
+  std::string m_path;
+  int m_fd = -1;
+  uint64_t m_readOffset = 0; // first record not consumed
+  uint64_t m_nextOffset = 0; // first record not handed out
+  uint64_t m_endOffset = 0;
+  std::deque<uint64_t> m_handedOutSizes; // record sizes between m_readOffset and m_nextOffset
+  bool m_hasUnsynced = false;
+};
+
+} // util
+} // mguard
+
+#endif // MGUARD_UTIL_SPILL_JOURNAL_HPP
@@ -0,0 +1,108 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "startup-barrier.hpp"
+
+#include <ndn-cxx/util/logger.hpp>
+
+#include <boost/algorithm/string/join.hpp>
+
+namespace mguard {
+namespace util {
+
+NDN_LOG_INIT(mguard.util.StartupBarrier);
+
+StartupBarrier::StartupBarrier(ndn::Scheduler& scheduler, const std::set<std::string>& conditions)
+: m_scheduler(scheduler)
+, m_pending(conditions)
+{
+}
+
+void
+StartupBarrier::satisfy(const std::string& condition)
+{
+  if (m_pending.erase(condition) == 0)
+    return;
+
+  NDN_LOG_DEBUG("Startup condition satisfied: " << condition << ", remaining: " << m_pending.size());
+  if (isReady() && m_isWaiting)
+    finish();
+}
+
+void
+StartupBarrier::fail(const std::string& condition, const std::string& reason)
+{
+  if (m_hasFailed || m_pending.count(condition) == 0)
+    return;
+
+  m_hasFailed = true;
+  m_failureReason = condition + ": " + reason;
+  NDN_LOG_ERROR("Startup condition failed, " << m_failureReason);
+  if (m_isWaiting)
+    finish(m_failureReason);
+}
+
+void
+StartupBarrier::wait(const ReadyCallback& onReady, const StartupFailureCallback& onFailure,
+                     ndn::time::milliseconds timeout)
+{
+  m_onReady = onReady;
+  m_onFailure = onFailure;
+  m_isWaiting = true;
+
+  // the conditions may be settled already
+  if (m_hasFailed) {
+    finish(m_failureReason);
+    return;
+  }
+  if (isReady()) {
+    finish();
+    return;
+  }
+
+  m_timeoutEvent = m_scheduler.schedule(timeout, [this, timeout] {
+    finish("timed out after " + ndn::to_string(timeout.count()) + " ms waiting for: " +
+           boost::algorithm::join(m_pending, ", "));
+  });
+}
+
+void
+StartupBarrier::finish(const std::string& failureReason)
+{
+  m_isWaiting = false;
+  m_timeoutEvent.cancel();
+
+  auto onReady = std::move(m_onReady);
+  auto onFailure = std::move(m_onFailure);
+  m_onReady = nullptr;
+  m_onFailure = nullptr;
+
+  if (failureReason.empty()) {
+    if (onReady)
+      onReady();
+  }
+  else {
+    m_hasFailed = true;
+    if (onFailure)
+      onFailure(failureReason);
+  }
+}
+
+} // util
+} // mguard
@@ -0,0 +1,102 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MGUARD_UTIL_STARTUP_BARRIER_HPP
+#define MGUARD_UTIL_STARTUP_BARRIER_HPP
+
+#include <ndn-cxx/util/scheduler.hpp>
+
+#include <boost/noncopyable.hpp>
+
+#include <functional>
+#include <set>
+#include <string>
+
+namespace mguard {
+namespace util {
+
+using ReadyCallback = std::function<void()>;
+using StartupFailureCallback = std::function<void(const std::string& reason)>;
+
+/*
+  Waits for the asynchronous steps of a startup (e.g. repo connected, prefix registered) instead
+  of sleeping for a fixed time.
+
+  Each step is a named condition that is satisfied or failed once. wait() calls the ready callback
+  as soon as all the conditions are satisfied, or the failure callback with the reason once a
+  condition fails or the timeout passes, naming the conditions still missing. Only one of the
+  callbacks is called, and only once.
+*/
+class StartupBarrier : boost::noncopyable
+{
+public:
+  StartupBarrier(ndn::Scheduler& scheduler, const std::set<std::string>& conditions);
+
+  void
+  satisfy(const std::string& condition);
+
+  void
+  fail(const std::string& condition, const std::string& reason);
+
+  /**
+   * @brief Call onReady once all the conditions are satisfied, onFailure if that doesn't happen
+   *  within the timeout. Replaces the callbacks of an earlier wait().
+  */
+  void
+  wait(const ReadyCallback& onReady, const StartupFailureCallback& onFailure,
+       ndn::time::milliseconds timeout);
+
+  bool
+  isReady() const
+  {
+    return m_pending.empty() && !m_hasFailed;
+  }
+
+  bool
+  hasFailed() const
+  {
+    return m_hasFailed;
+  }
+
+  // conditions not satisfied yet
+  const std::set<std::string>&
+  getPending() const
+  {
+    return m_pending;
+  }
+
+private:
+  void
+  finish(const std::string& failureReason = "");
+
+private:
+  ndn::Scheduler& m_scheduler;
+  std::set<std::string> m_pending;
+  bool m_hasFailed = false;
+  std::string m_failureReason;
+  bool m_isWaiting = false;
+  ReadyCallback m_onReady;
+  StartupFailureCallback m_onFailure;
+  ndn::scheduler::ScopedEventId m_timeoutEvent;
+};
+
+} // util
+} // mguard
+
+#endif // MGUARD_UTIL_STARTUP_BARRIER_HPP
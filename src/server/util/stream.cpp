@@ -28,12 +28,14 @@ namespace util {
 
 NDN_LOG_INIT(mguard.Stream);
 
-Stream::Stream(const ndn::Name& streamName)
+Stream::Stream(const ndn::Name& streamName, const BatchingPolicy& policy)
 : m_streamName(streamName)
-, m_manifestCounter (0)
+, m_batchingPolicy(policy)
 {
   m_manifestName = m_streamName;
   m_manifestName.append("MANIFEST");
+  m_indexName = m_manifestName;
+  m_indexName.append("INDEX");
 
   NDN_LOG_DEBUG("Stream Name: " << m_streamName);
   NDN_LOG_DEBUG("Manifest name: " << m_manifestName);
@@ -43,14 +45,32 @@ bool
 Stream::updateManifestList(const ndn::Name& dataNameWithDigest)
 {
   m_manifestList.push_back(dataNameWithDigest);
-  if (m_manifestCounter == MANIFEST_BATCH_SIZE - 1)
-    {
-      m_manifestCounter = 0; // reset the counter
-      return true; // time to publish the manifest
-    }
-  
-  ++m_manifestCounter;
-  return false;
+  return m_batchingPolicy.onAppend(dataNameWithDigest.wireEncode().size());
+}
+
+std::optional<manifest::ManifestIndex>
+Stream::updateIndex(uint64_t manifestSeq, const ndn::time::system_clock::time_point& now)
+{
+  auto bucketOf = [] (const ndn::time::system_clock::time_point& tp) {
+    return ndn::time::toUnixTimestamp(tp).count() / MANIFEST_INDEX_INTERVAL.count();
+  };
+
+  std::optional<manifest::ManifestIndex> closed;
+  if (m_openIndex && bucketOf(m_openIndex->startTime) != bucketOf(now)) {
+    NDN_LOG_DEBUG("Index bucket of: " << m_manifestName << " complete, manifests: "
+                  << m_openIndex->firstSeq << " - " << m_openIndex->lastSeq);
+    closed = std::move(m_openIndex);
+    m_openIndex.reset();
+  }
+
+  if (!m_openIndex) {
+    m_openIndex = manifest::ManifestIndex{now, now, manifestSeq, manifestSeq};
+  }
+  else {
+    m_openIndex->endTime = now;
+    m_openIndex->lastSeq = manifestSeq;
+  }
+  return closed;
 }
 
 } // util
@@ -20,9 +20,13 @@
 #ifndef MGUARD_STREAM_HPP
 #define MGUARD_STREAM_HPP
 
+#include "batching-policy.hpp"
+#include "../../manifest.hpp"
+
 #include <ndn-cxx/name.hpp>
 #include <string>
 #include <algorithm>
+#include <optional>
 #include <regex>
 
 namespace mguard {
@@ -40,17 +44,37 @@ getNdnNameFromSemanticLocationName(std::string md2kname)
 class Stream
 {
 public:
-  Stream(const ndn::Name& streamName);
+  Stream(const ndn::Name& streamName, const BatchingPolicy& policy = BatchingPolicy::makeDefault());
 
   /*
    This function will update the manifest list and send status whether it is reedy to be published or not
-   e.g. if 20 new data names are added or X ms/s time has passed since addition of the last data poing,
-   manifest will be read to be published
-   for time expiration, we need to use signal ??
+   according to the batching policy of the stream, e.g. if 50 new data names are added or the names
+   reached the byte limit. Time based publication is done by the publisher using getFlushDelay()
   */
   bool
   updateManifestList(const ndn::Name& dataNameWithDigest);
 
+  /*
+    Time after which the manifest has to be published if no other data name is added
+  */
+  ndn::time::milliseconds
+  getFlushDelay() const
+  {
+    return m_batchingPolicy.getFlushDelay();
+  }
+
+  BatchingPolicy&
+  getBatchingPolicy()
+  {
+    return m_batchingPolicy;
+  }
+
+  void
+  setBatchingPolicy(const BatchingPolicy& policy)
+  {
+    m_batchingPolicy = policy;
+  }
+
   std::vector<ndn::Name>&
   getManifestList()
   {
@@ -64,6 +88,7 @@ public:
   resetManifestList()
   {
     m_manifestList.clear();
+    m_batchingPolicy.onFlush();
   }
 
   ndn::Name&
@@ -84,11 +109,74 @@ public:
     return m_manifestName;
   }
 
+  /*
+    Prefix of the index objects of the stream, i.e. /<stream>/MANIFEST/INDEX
+  */
+  const ndn::Name&
+  getIndexName() const
+  {
+    return m_indexName;
+  }
+
+  /*
+    Record a published manifest in the index bucket (MANIFEST_INDEX_INTERVAL) of its publication time.
+    If the manifest starts a new bucket, the previous bucket is complete and returned for publication
+  */
+  std::optional<manifest::ManifestIndex>
+  updateIndex(uint64_t manifestSeq, const ndn::time::system_clock::time_point& now);
+
+  const std::optional<manifest::ManifestIndex>&
+  getOpenIndex() const
+  {
+    return m_openIndex;
+  }
+
+  /*
+    Restore the index bucket of the manifests published before a restart
+  */
+  void
+  setOpenIndex(const std::optional<manifest::ManifestIndex>& index)
+  {
+    m_openIndex = index;
+  }
+
+  const std::optional<ndn::time::system_clock::time_point>&
+  getLastPublished() const
+  {
+    return m_lastPublished;
+  }
+
+  void
+  setLastPublished(const ndn::time::system_clock::time_point& time)
+  {
+    m_lastPublished = time;
+  }
+
+  /*
+    Dense index of the stream in the publisher, used to key per-stream timers
+  */
+  size_t
+  getIndex() const
+  {
+    return m_index;
+  }
+
+  void
+  setIndex(size_t index)
+  {
+    m_index = index;
+  }
+
 private:
   ndn::Name m_streamName;
   ndn::Name m_manifestName;
   std::vector<ndn::Name> m_manifestList;
-  int m_manifestCounter;
+  BatchingPolicy m_batchingPolicy;
+  size_t m_index = 0;
+
+  ndn::Name m_indexName;
+  std::optional<manifest::ManifestIndex> m_openIndex; // bucket of the latest manifests, not published yet
+  std::optional<ndn::time::system_clock::time_point> m_lastPublished; // of the latest manifest
 
 };
 } // util
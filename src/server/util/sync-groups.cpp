@@ -0,0 +1,223 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sync-groups.hpp"
+#include "../../common.hpp"
+
+#include <ndn-cxx/util/logger.hpp>
+
+namespace mguard {
+namespace util {
+
+NDN_LOG_INIT(mguard.util.SyncGroups);
+
+SyncGroups::SyncGroups(ndn::Face& face, ndn::security::KeyChain& keyChain, const ndn::Name& syncPrefix,
+                       ndn::time::milliseconds coalesceWindow)
+: m_face(face)
+, m_keyChain(keyChain)
+, m_scheduler(face.getIoService())
+, m_syncPrefix(syncPrefix)
+, m_coalesceWindow(coalesceWindow)
+{
+  makeProducer(m_topLevel, m_syncPrefix, SYNC_MIN_IBF_SIZE);
+}
+
+bool
+SyncGroups::addPrefix(const ndn::Name& streamName, const ndn::Name& prefix)
+{
+  if (m_groupOfPrefix.count(prefix) > 0)
+    return false;
+
+  auto groupPrefix = getSyncGroupPrefix(m_syncPrefix, streamName);
+  auto it = m_groups.find(groupPrefix);
+  if (it == m_groups.end()) {
+    NDN_LOG_INFO("Creating sync group: " << groupPrefix);
+    it = m_groups.emplace(groupPrefix, Group()).first;
+    makeProducer(it->second, groupPrefix, SYNC_MIN_IBF_SIZE);
+    addUserNode(m_topLevel, m_syncPrefix, groupPrefix);
+  }
+
+  addUserNode(it->second, groupPrefix, prefix);
+  m_groupOfPrefix.emplace(prefix, groupPrefix);
+  bumpVersion(groupPrefix);
+  return true;
+}
+
+void
+SyncGroups::publishName(const ndn::Name& prefix, uint64_t seq)
+{
+  auto it = m_groupOfPrefix.find(prefix);
+  if (it == m_groupOfPrefix.end()) {
+    NDN_LOG_ERROR("Prefix: " << prefix << " is not in a sync group, not publishing");
+    return;
+  }
+  publishToGroup(it->second, prefix, seq);
+}
+
+std::optional<uint64_t>
+SyncGroups::getSeqNo(const ndn::Name& prefix) const
+{
+  auto it = m_groupOfPrefix.find(prefix);
+  if (it == m_groupOfPrefix.end())
+    return std::nullopt;
+  return getLatestSeqNo(it->second, prefix);
+}
+
+void
+SyncGroups::announce(const ndn::Name& prefix, uint64_t seq)
+{
+  if (m_topLevel.prefixes.count(prefix) == 0)
+    addUserNode(m_topLevel, m_syncPrefix, prefix);
+  publishToGroup(m_syncPrefix, prefix, seq);
+}
+
+std::optional<uint64_t>
+SyncGroups::getGroupVersion(const ndn::Name& groupPrefix) const
+{
+  return getLatestSeqNo(m_syncPrefix, groupPrefix);
+}
+
+void
+SyncGroups::flush()
+{
+  m_isFlushScheduled = false;
+  // called while getSeqNo() still returns the collected sequence numbers
+  if (!m_pending.empty() && m_beforeUpdate)
+    m_beforeUpdate();
+
+  auto pending = std::move(m_pending);
+  m_pending.clear();
+
+  for (const auto& [syncPrefix, update] : pending) {
+    NDN_LOG_DEBUG("Publishing: " << update.seqNos.size() << " prefixes of: " << syncPrefix
+                  << " in one update, published: " << update.nPublished);
+    getGroup(syncPrefix).producer->publishNames(update.seqNos);
+    m_nSavedUpdates += update.nPublished - 1;
+  }
+}
+
+SyncGroups::Group&
+SyncGroups::getGroup(const ndn::Name& syncPrefix)
+{
+  return syncPrefix == m_syncPrefix ? m_topLevel : m_groups.at(syncPrefix);
+}
+
+const SyncGroups::Group&
+SyncGroups::getGroup(const ndn::Name& syncPrefix) const
+{
+  return syncPrefix == m_syncPrefix ? m_topLevel : m_groups.at(syncPrefix);
+}
+
+void
+SyncGroups::publishToGroup(const ndn::Name& syncPrefix, const ndn::Name& prefix, uint64_t seq)
+{
+  auto& update = m_pending[syncPrefix];
+  auto& pendingSeq = update.seqNos[prefix];
+  pendingSeq = std::max(pendingSeq, seq);
+  ++update.nPublished;
+
+  if (m_coalesceWindow <= ndn::time::milliseconds::zero()) {
+    flush();
+    return;
+  }
+
+  if (!m_isFlushScheduled) {
+    m_isFlushScheduled = true;
+    m_scheduler.schedule(m_coalesceWindow, [this] { flush(); });
+  }
+}
+
+std::optional<uint64_t>
+SyncGroups::getLatestSeqNo(const ndn::Name& syncPrefix, const ndn::Name& prefix) const
+{
+  auto update = m_pending.find(syncPrefix);
+  if (update != m_pending.end()) {
+    auto it = update->second.seqNos.find(prefix);
+    if (it != update->second.seqNos.end())
+      return it->second;
+  }
+  return getGroup(syncPrefix).producer->getSeqNo(prefix);
+}
+
+std::optional<ndn::Name>
+SyncGroups::getGroupOf(const ndn::Name& prefix) const
+{
+  auto it = m_groupOfPrefix.find(prefix);
+  if (it == m_groupOfPrefix.end())
+    return std::nullopt;
+  return it->second;
+}
+
+size_t
+SyncGroups::getIbfSize(const ndn::Name& groupPrefix) const
+{
+  if (groupPrefix == m_syncPrefix)
+    return m_topLevel.capacity;
+  auto it = m_groups.find(groupPrefix);
+  return it == m_groups.end() ? 0 : it->second.capacity;
+}
+
+void
+SyncGroups::makeProducer(Group& group, const ndn::Name& syncPrefix, size_t expectedEntries)
+{
+  std::map<ndn::Name, uint64_t> seqNos;
+  if (group.producer) {
+    for (const auto& prefix : group.prefixes)
+      seqNos.emplace(prefix, group.producer->getSeqNo(prefix).value_or(0));
+  }
+
+  // the old producer unregisters the sync prefix before the new one registers it
+  group.producer.reset();
+  group.capacity = expectedEntries;
+  group.producer = std::make_unique<CoalescingPartialProducer>(m_face, m_keyChain, expectedEntries,
+                                                               syncPrefix, ndn::Name());
+  for (const auto& prefix : group.prefixes) {
+    group.producer->addUserNode(prefix);
+    auto seqNo = seqNos[prefix];
+    if (seqNo > 0)
+      group.producer->publishName(prefix, seqNo);
+  }
+}
+
+bool
+SyncGroups::addUserNode(Group& group, const ndn::Name& syncPrefix, const ndn::Name& prefix)
+{
+  group.prefixes.insert(prefix);
+  if (group.prefixes.size() <= group.capacity) {
+    group.producer->addUserNode(prefix);
+    return false;
+  }
+
+  auto expectedEntries = getSyncStateSize(group.prefixes.size(), SYNC_MIN_IBF_SIZE);
+  NDN_LOG_INFO("Resizing IBF of: " << syncPrefix << " from: " << group.capacity << " to: "
+               << expectedEntries << " entries");
+  makeProducer(group, syncPrefix, expectedEntries);
+  return true;
+}
+
+void
+SyncGroups::bumpVersion(const ndn::Name& groupPrefix)
+{
+  auto version = getGroupVersion(groupPrefix).value_or(0) + 1;
+  NDN_LOG_DEBUG("Sync group: " << groupPrefix << " version: " << version);
+  publishToGroup(m_syncPrefix, groupPrefix, version);
+}
+
+} // util
+} // mguard
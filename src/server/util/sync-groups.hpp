@@ -0,0 +1,183 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MGUARD_UTIL_SYNC_GROUPS_HPP
+#define MGUARD_UTIL_SYNC_GROUPS_HPP
+
+#include "coalescing-partial-producer.hpp"
+
+#include <ndn-cxx/face.hpp>
+#include <ndn-cxx/util/scheduler.hpp>
+#include <ndn-cxx/security/key-chain.hpp>
+
+#include <boost/noncopyable.hpp>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+
+namespace mguard {
+namespace util {
+
+/*
+  Partial sync producers of the stream groups (see getSyncGroupPrefix) and of the top-level group
+  under the sync prefix, whose user prefixes are the group prefixes and whose sequence numbers are
+  the group versions.
+
+  A group is created with the first prefix of one of its streams. The version of a group is bumped
+  whenever a prefix is added to it or its IBF is resized, consumers of the group send a hello
+  interest on that to learn the new prefixes and the new IBF. The IBF of every producer is rebuilt
+  once its prefixes outgrow it, keeping their sequence numbers.
+
+  Sequence numbers published within the coalescing window are collected per group and applied as
+  one sync update when the window ends, getSeqNo() already returns them meanwhile. The update
+  callback is called right before they are applied (e.g. to persist them first).
+*/
+class SyncGroups : boost::noncopyable
+{
+public:
+  using UpdateCallback = std::function<void()>;
+
+  /**
+   * @param coalesceWindow publishing is delayed by up to this long, zero publishes right away
+  */
+  SyncGroups(ndn::Face& face, ndn::security::KeyChain& keyChain, const ndn::Name& syncPrefix,
+             ndn::time::milliseconds coalesceWindow);
+
+  /**
+   * @brief Add a user prefix (e.g. manifest prefix) of a stream to the group of the stream
+   * @return false if it was added before
+  */
+  bool
+  addPrefix(const ndn::Name& streamName, const ndn::Name& prefix);
+
+  /**
+   * @brief Publish a sequence number of a prefix added before, with the other sequence numbers
+   *  of its group published in the coalescing window
+  */
+  void
+  publishName(const ndn::Name& prefix, uint64_t seq);
+
+  std::optional<uint64_t>
+  getSeqNo(const ndn::Name& prefix) const;
+
+  /**
+   * @brief Publish a sequence number of a prefix of the top-level group, next to the group versions
+   *  (e.g. the version of the stream catalog)
+  */
+  void
+  announce(const ndn::Name& prefix, uint64_t seq);
+
+  // version of a group, or the sequence number of an announced prefix
+  std::optional<uint64_t>
+  getGroupVersion(const ndn::Name& groupPrefix) const;
+
+  // group prefix of an added prefix
+  std::optional<ndn::Name>
+  getGroupOf(const ndn::Name& prefix) const;
+
+  size_t
+  getIbfSize(const ndn::Name& groupPrefix) const;
+
+  size_t
+  size() const
+  {
+    return m_groups.size();
+  }
+
+  // sync updates saved by coalescing, i.e. published sequence numbers minus updates sent to the sync
+  uint64_t
+  getSavedUpdates() const
+  {
+    return m_nSavedUpdates;
+  }
+
+  void
+  setBeforeUpdateCallback(const UpdateCallback& callback)
+  {
+    m_beforeUpdate = callback;
+  }
+
+  /**
+   * @brief Apply the collected sequence numbers now
+  */
+  void
+  flush();
+
+private:
+  struct Group
+  {
+    std::set<ndn::Name> prefixes;
+    size_t capacity = 0; // expected number of entries of the IBF
+    std::unique_ptr<CoalescingPartialProducer> producer;
+  };
+
+  struct PendingUpdate
+  {
+    std::map<ndn::Name, uint64_t> seqNos;
+    size_t nPublished = 0;
+  };
+
+  Group&
+  getGroup(const ndn::Name& syncPrefix);
+
+  const Group&
+  getGroup(const ndn::Name& syncPrefix) const;
+
+  void
+  publishToGroup(const ndn::Name& syncPrefix, const ndn::Name& prefix, uint64_t seq);
+
+  // latest sequence number of a prefix of a group, collected ones included
+  std::optional<uint64_t>
+  getLatestSeqNo(const ndn::Name& syncPrefix, const ndn::Name& prefix) const;
+
+  void
+  makeProducer(Group& group, const ndn::Name& syncPrefix, size_t expectedEntries);
+
+  /**
+   * @brief Add a user prefix to the producer of the group, resizing it if needed
+   * @return whether the IBF was resized
+  */
+  bool
+  addUserNode(Group& group, const ndn::Name& syncPrefix, const ndn::Name& prefix);
+
+  void
+  bumpVersion(const ndn::Name& groupPrefix);
+
+private:
+  ndn::Face& m_face;
+  ndn::security::KeyChain& m_keyChain;
+  ndn::Scheduler m_scheduler;
+  ndn::Name m_syncPrefix;
+  ndn::time::milliseconds m_coalesceWindow;
+  std::map<ndn::Name, PendingUpdate> m_pending; // by sync prefix of the group
+  bool m_isFlushScheduled = false;
+  UpdateCallback m_beforeUpdate;
+  uint64_t m_nSavedUpdates = 0;
+  Group m_topLevel;
+  std::map<ndn::Name, Group> m_groups;
+  std::map<ndn::Name, ndn::Name> m_groupOfPrefix;
+};
+
+} // util
+} // mguard
+
+#endif // MGUARD_UTIL_SYNC_GROUPS_HPP
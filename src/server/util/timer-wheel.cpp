@@ -0,0 +1,189 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "timer-wheel.hpp"
+
+#include <ndn-cxx/util/logger.hpp>
+
+namespace mguard {
+namespace util {
+
+NDN_LOG_INIT(mguard.util.TimerWheel);
+
+TimerWheel::TimerWheel(ndn::Scheduler& scheduler, ndn::time::milliseconds tick,
+                       const TimerExpiryCallback& onExpiry)
+: m_scheduler(scheduler)
+, m_tick(tick)
+, m_onExpiry(onExpiry)
+, m_epoch(ndn::time::steady_clock::now())
+, m_slots(LEVEL0_SIZE + 2 * LEVEL_SIZE, NIL)
+{
+  BOOST_ASSERT(m_tick > ndn::time::nanoseconds::zero());
+}
+
+void
+TimerWheel::reserve(size_t nTimers)
+{
+  if (nTimers > m_timers.size())
+    m_timers.resize(nTimers);
+  m_expired.reserve(nTimers);
+}
+
+uint64_t
+TimerWheel::getNowTick() const
+{
+  return static_cast<uint64_t>((ndn::time::steady_clock::now() - m_epoch) / m_tick);
+}
+
+void
+TimerWheel::schedule(size_t id, ndn::time::milliseconds delay)
+{
+  if (id >= m_timers.size())
+    reserve(std::max(id + 1, m_timers.size() * 2));
+
+  if (isScheduled(id))
+    unlink(id);
+  else
+    ++m_nScheduled;
+
+  auto nowTick = getNowTick();
+  if (m_nScheduled == 1) {
+    // the wheel was idle, catch up without going through the missed ticks
+    m_currentTick = std::max(m_currentTick, nowTick);
+  }
+
+  // round the deadline up to the next tick boundary, a timer never fires early
+  auto deadline = ndn::time::steady_clock::now() - m_epoch + delay;
+  uint64_t expiry = (deadline + m_tick - ndn::time::nanoseconds(1)) / m_tick;
+  m_timers[id].expiry = std::max(expiry, std::max(nowTick, m_currentTick) + 1);
+  link(id);
+
+  if (!m_tickEvent) {
+    m_tickEvent = m_scheduler.schedule(m_tick, [this] { advance(); });
+  }
+}
+
+void
+TimerWheel::cancel(size_t id)
+{
+  if (!isScheduled(id))
+    return;
+
+  unlink(id);
+  --m_nScheduled;
+
+  if (m_nScheduled == 0)
+    m_tickEvent.cancel();
+}
+
+void
+TimerWheel::link(uint32_t id)
+{
+  auto& timer = m_timers[id];
+  if (timer.expiry - m_currentTick >= MAX_TICKS)
+    timer.expiry = m_currentTick + MAX_TICKS - 1;
+
+  auto delta = timer.expiry - m_currentTick;
+  uint32_t slot;
+  if (delta < LEVEL0_SIZE) {
+    slot = timer.expiry & (LEVEL0_SIZE - 1);
+  }
+  else if (delta < LEVEL0_SIZE * LEVEL_SIZE) {
+    slot = LEVEL0_SIZE + ((timer.expiry >> LEVEL0_BITS) & (LEVEL_SIZE - 1));
+  }
+  else {
+    slot = LEVEL0_SIZE + LEVEL_SIZE + ((timer.expiry >> (LEVEL0_BITS + LEVEL_BITS)) & (LEVEL_SIZE - 1));
+  }
+
+  timer.slot = slot;
+  timer.prev = NIL;
+  timer.next = m_slots[slot];
+  if (timer.next != NIL)
+    m_timers[timer.next].prev = id;
+  m_slots[slot] = id;
+}
+
+void
+TimerWheel::unlink(uint32_t id)
+{
+  auto& timer = m_timers[id];
+  if (timer.prev != NIL)
+    m_timers[timer.prev].next = timer.next;
+  else
+    m_slots[timer.slot] = timer.next;
+
+  if (timer.next != NIL)
+    m_timers[timer.next].prev = timer.prev;
+
+  timer.prev = timer.next = timer.slot = NIL;
+}
+
+void
+TimerWheel::cascade(uint32_t slot)
+{
+  auto id = m_slots[slot];
+  m_slots[slot] = NIL;
+  while (id != NIL) {
+    auto next = m_timers[id].next;
+    link(id);
+    id = next;
+  }
+}
+
+void
+TimerWheel::advance()
+{
+  auto nowTick = getNowTick();
+  while (m_currentTick < nowTick && m_nScheduled > m_expired.size()) {
+    ++m_currentTick;
+
+    if ((m_currentTick & (LEVEL0_SIZE - 1)) == 0) {
+      auto index1 = (m_currentTick >> LEVEL0_BITS) & (LEVEL_SIZE - 1);
+      if (index1 == 0) {
+        auto index2 = (m_currentTick >> (LEVEL0_BITS + LEVEL_BITS)) & (LEVEL_SIZE - 1);
+        cascade(LEVEL0_SIZE + LEVEL_SIZE + index2);
+      }
+      cascade(LEVEL0_SIZE + index1);
+    }
+
+    uint32_t slot = m_currentTick & (LEVEL0_SIZE - 1);
+    while (m_slots[slot] != NIL) {
+      auto id = m_slots[slot];
+      unlink(id);
+      m_expired.push_back(id);
+    }
+  }
+  // nothing left to fire, no need to walk through the remaining ticks
+  m_currentTick = std::max(m_currentTick, nowTick);
+
+  m_tickEvent.cancel();
+  if (!m_expired.empty()) {
+    m_nScheduled -= m_expired.size();
+    NDN_LOG_TRACE("Timers expired: " << m_expired.size() << ", pending: " << m_nScheduled);
+    // expired timers are already unlinked, the callback can schedule them again
+    m_onExpiry(m_expired);
+    m_expired.clear();
+  }
+
+  if (m_nScheduled > 0 && !m_tickEvent)
+    m_tickEvent = m_scheduler.schedule(m_tick, [this] { advance(); });
+}
+
+} // util
+} // mguard
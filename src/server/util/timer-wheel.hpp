@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MGUARD_UTIL_TIMER_WHEEL_HPP
+#define MGUARD_UTIL_TIMER_WHEEL_HPP
+
+#include <ndn-cxx/util/scheduler.hpp>
+
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace mguard {
+namespace util {
+
+using TimerExpiryCallback = std::function<void(const std::vector<size_t>& expired)>;
+
+/*
+  Hierarchical timer wheel for a large number of deadlines identified by a dense index
+  (e.g. manifest flush deadline of each stream).
+
+  Three levels: 256 slots of one tick, 64 slots of 256 ticks and 64 slots of 16384 ticks.
+  Timers are kept in intrusive doubly linked lists (by index) so moving a deadline is O(1)
+  and doesn't allocate once the index range is reserved. Far timers are cascaded down a
+  level when the lower level wraps around. Deadlines beyond the last level are clamped,
+  i.e. the wheel covers about 2^20 ticks.
+
+  The wheel is driven by a single scheduler event per tick, only while timers are pending.
+  All timers expired since the last tick are delivered in one callback.
+*/
+class TimerWheel
+{
+public:
+  TimerWheel(ndn::Scheduler& scheduler, ndn::time::milliseconds tick,
+             const TimerExpiryCallback& onExpiry);
+
+  // make room for timers 0..nTimers-1, scheduling within that range won't allocate
+  void
+  reserve(size_t nTimers);
+
+  /**
+   * @brief Schedule timer @p id to expire after @p delay, moves the timer if it is already scheduled
+   *  The delay is rounded up to the next tick.
+  */
+  void
+  schedule(size_t id, ndn::time::milliseconds delay);
+
+  void
+  cancel(size_t id);
+
+  bool
+  isScheduled(size_t id) const
+  {
+    return id < m_timers.size() && m_timers[id].slot != NIL;
+  }
+
+  // number of pending timers
+  size_t
+  size() const
+  {
+    return m_nScheduled;
+  }
+
+private:
+  static constexpr uint32_t NIL = std::numeric_limits<uint32_t>::max();
+  static constexpr unsigned LEVEL0_BITS = 8;
+  static constexpr unsigned LEVEL_BITS = 6;
+  static constexpr uint64_t LEVEL0_SIZE = 1 << LEVEL0_BITS;
+  static constexpr uint64_t LEVEL_SIZE = 1 << LEVEL_BITS;
+  static constexpr uint64_t MAX_TICKS = LEVEL0_SIZE * LEVEL_SIZE * LEVEL_SIZE;
+
+  struct Timer
+  {
+    uint64_t expiry = 0; // in ticks
+    uint32_t prev = NIL;
+    uint32_t next = NIL;
+    uint32_t slot = NIL; // NIL if not scheduled
+  };
+
+  uint64_t
+  getNowTick() const;
+
+  void
+  link(uint32_t id);
+
+  void
+  unlink(uint32_t id);
+
+  // re-insert all timers of a slot relative to the current tick
+  void
+  cascade(uint32_t slot);
+
+  void
+  advance();
+
+private:
+  ndn::Scheduler& m_scheduler;
+  ndn::time::nanoseconds m_tick;
+  TimerExpiryCallback m_onExpiry;
+  ndn::time::steady_clock::time_point m_epoch;
+  uint64_t m_currentTick = 0;
+  ndn::scheduler::ScopedEventId m_tickEvent;
+
+  std::vector<Timer> m_timers;
+  std::vector<uint32_t> m_slots; // list head of each slot, level 0 then level 1 then level 2
+  std::vector<size_t> m_expired;
+  size_t m_nScheduled = 0;
+};
+
+} // util
+} // mguard
+
+#endif // MGUARD_UTIL_TIMER_WHEEL_HPP
@@ -0,0 +1,104 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hmac-validator.hpp"
+
+#include <ndn-cxx/encoding/buffer-stream.hpp>
+#include <ndn-cxx/security/certificate-fetcher-offline.hpp>
+#include <ndn-cxx/security/transform/base64-decode.hpp>
+#include <ndn-cxx/security/transform/buffer-source.hpp>
+#include <ndn-cxx/security/transform/signer-filter.hpp>
+#include <ndn-cxx/security/transform/stream-sink.hpp>
+#include <ndn-cxx/util/logger.hpp>
+
+NDN_LOG_INIT(mguard.HmacValidator);
+
+namespace mguard {
+namespace subscriber {
+
+namespace tr = ndn::security::transform;
+
+std::shared_ptr<HmacKey>
+makeHmacKey(const std::string& base64Key)
+{
+  ndn::OBufferStream os;
+  tr::bufferSource(base64Key) >> tr::base64Decode(false) >> tr::streamSink(os);
+  auto key = std::make_shared<HmacKey>();
+  key->loadRaw(ndn::KeyType::HMAC, *os.buf());
+  return key;
+}
+
+bool
+verifyHmacSignature(const ndn::Data& data, const HmacKey& key)
+{
+  if (data.getSignatureType() != ndn::tlv::SignatureHmacWithSha256)
+    return false;
+
+  ndn::OBufferStream os;
+  tr::bufferSource(data.extractSignedRanges())
+    >> tr::signerFilter(ndn::DigestAlgorithm::SHA256, key)
+    >> tr::streamSink(os);
+
+  auto expected = os.buf();
+  const auto& sigValue = data.getSignatureValue();
+  if (expected->size() != sigValue.value_size())
+    return false;
+
+  // constant time, the position of the first mismatch must not leak through the timing
+  uint8_t diff = 0;
+  auto value = sigValue.value_begin();
+  for (size_t i = 0; i < expected->size(); ++i) {
+    diff |= (*expected)[i] ^ value[i];
+  }
+  return diff == 0;
+}
+
+HmacValidationPolicy::HmacValidationPolicy(std::shared_ptr<const HmacKey> key)
+: m_key(std::move(key))
+{
+}
+
+void
+HmacValidationPolicy::checkPolicy(const ndn::Data& data, const std::shared_ptr<ndn::security::ValidationState>& state,
+                                  const ValidationContinuation& continueValidation)
+{
+  if (!verifyHmacSignature(data, *m_key)) {
+    NDN_LOG_DEBUG("Invalid HMAC signature: " << data.getName());
+    state->fail({ndn::security::ValidationError::INVALID_SIGNATURE, "Invalid HMAC signature"});
+    return;
+  }
+  // nothing to fetch, the shared key is the trust anchor
+  continueValidation(nullptr, state);
+}
+
+void
+HmacValidationPolicy::checkPolicy(const ndn::Interest& interest, const std::shared_ptr<ndn::security::ValidationState>& state,
+                                  const ValidationContinuation& continueValidation)
+{
+  state->fail({ndn::security::ValidationError::POLICY_ERROR, "HMAC signed interests are not accepted"});
+}
+
+HmacValidator::HmacValidator(std::shared_ptr<const HmacKey> key)
+: Validator(std::make_unique<HmacValidationPolicy>(std::move(key)),
+            std::make_unique<ndn::security::CertificateFetcherOffline>())
+{
+}
+
+} // subscriber
+} // mguard
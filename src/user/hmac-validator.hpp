@@ -0,0 +1,86 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MGUARD_HMAC_VALIDATOR_HPP
+#define MGUARD_HMAC_VALIDATOR_HPP
+
+#include <ndn-cxx/security/validation-policy.hpp>
+#include <ndn-cxx/security/validator.hpp>
+#include <ndn-cxx/security/transform/private-key.hpp>
+
+#include <memory>
+#include <string>
+
+namespace mguard {
+namespace subscriber {
+
+using HmacKey = ndn::security::transform::PrivateKey;
+
+/**
+ * @brief Decode the base64 encoded shared key (see loadHmacKey)
+*/
+std::shared_ptr<HmacKey>
+makeHmacKey(const std::string& base64Key);
+
+/**
+ * @brief Verify a packet signed with the shared HMAC key (MANIFEST_SIGNER = HMAC)
+ *
+ *  The signature value is compared in constant time.
+ * @return true if the packet carries a valid HMAC signature
+*/
+bool
+verifyHmacSignature(const ndn::Data& data, const HmacKey& key);
+
+/*
+  Accepts only data signed with the shared HMAC key, which the trust schema can't check.
+  Interests are rejected, HMAC signed ones are not used.
+*/
+class HmacValidationPolicy : public ndn::security::ValidationPolicy
+{
+public:
+  explicit
+  HmacValidationPolicy(std::shared_ptr<const HmacKey> key);
+
+  void
+  checkPolicy(const ndn::Data& data, const std::shared_ptr<ndn::security::ValidationState>& state,
+              const ValidationContinuation& continueValidation) override;
+
+  void
+  checkPolicy(const ndn::Interest& interest, const std::shared_ptr<ndn::security::ValidationState>& state,
+              const ValidationContinuation& continueValidation) override;
+
+private:
+  std::shared_ptr<const HmacKey> m_key;
+};
+
+/*
+  Validator of HMAC signed manifests and catalogs. Given to the SegmentFetcher, such that a segment
+  with a bad signature fails the fetch (SEGMENT_VALIDATION_FAIL) before it is reassembled.
+*/
+class HmacValidator : public ndn::security::Validator
+{
+public:
+  explicit
+  HmacValidator(std::shared_ptr<const HmacKey> key);
+};
+
+} // namespace subscriber
+} // namespace mguard
+
+#endif // MGUARD_HMAC_VALIDATOR_HPP
@@ -19,14 +19,18 @@
 
 #include "subscriber.hpp"
 #include "../common.hpp"
+#include "../manifest.hpp"
 
 #include <nac-abe/attribute-authority.hpp>
 
+#include <ndn-cxx/util/segment-fetcher.hpp>
+
 #include <boost/algorithm/string.hpp>
 
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <optional>
 
 NDN_LOG_INIT(mguard.subscriber);
 
@@ -46,13 +50,7 @@ Subscriber::Subscriber(const ndn::Name& consumerPrefix, const ndn::Name& syncPre
 , m_controllerPrefix(controllerPrefix)
 
 , m_abe_consumer(m_face, m_keyChain, m_validator, *loadCert(consumerCertPath), *loadCert(aaCertPath))
-
-, m_psync_consumer(m_syncPrefix, m_face,
-                   std::bind(&Subscriber::receivedHelloData, this, _1),
-                   std::bind(&Subscriber::receivedSyncUpdates, this, _1),
-                   3, 0.001, 1_s, SYNC_INTEREST_LIFETIME) 
-                   /* 3 = expected number of prefix to subscriber to, need to handle this differently later
-                      1_s hello interset lifetime, SYNC_INTEREST_LIFETIME = 1600_ms sync interest life time */
+, m_catalogPrefix(ndn::Name(m_syncPrefix).append(STREAM_CATALOG_COMPONENT))
 , m_ApplicationDataCallback(callback)
 , m_subCallback(subCallback)
 {
@@ -64,8 +62,18 @@ Subscriber::Subscriber(const ndn::Name& consumerPrefix, const ndn::Name& syncPre
 //                        },
 //                        nullptr,
 //                        nullptr);
-  m_psync_consumer.sendHelloInterest();
+  m_topLevel.capacity = SYNC_MIN_SUBSCRIPTIONS;
+  m_topLevel.consumer = makeConsumer(m_syncPrefix, m_topLevel.capacity);
+  m_topLevel.consumer->sendHelloInterest();
+  scheduleHelloRefresh();
+  sendCatalogNotify();
   m_validator.load("certs/trust-schema.conf");
+
+  if (MANIFEST_SIGNER == ManifestSigner::HMAC) {
+    NDN_LOG_DEBUG("Loading manifest HMAC key from: " << MANIFEST_HMAC_KEY_PATH);
+    m_manifestHmacKey = makeHmacKey(loadHmacKey(MANIFEST_HMAC_KEY_PATH));
+    m_hmacValidator = std::make_unique<HmacValidator>(m_manifestHmacKey);
+  }
   // loadCert("certs/producer.cert"); // need this ?? 
   
   /*
@@ -159,6 +167,15 @@ void
 Subscriber::onData(const ndn::Interest& interest, const ndn::Data& data)
 {
   NDN_LOG_INFO("Data received for: " << interest.getName());
+
+  if (data.getSignatureType() == ndn::tlv::SignatureHmacWithSha256) {
+    if (verifyHmacSignature(data))
+      wireDecode(data.getContent());
+    else
+      std::cerr << "Cannot validate retrieved data: invalid HMAC signature" << std::endl;
+    return;
+  }
+
   /* With validation */
   m_validator.validate(data,
     [=] (const ndn::Data& data) {
@@ -170,6 +187,17 @@ Subscriber::onData(const ndn::Interest& interest, const ndn::Data& data)
   // wireDecode(data.getContent());
 }
 
+bool
+Subscriber::verifyHmacSignature(const ndn::Data& data)
+{
+  if (!m_manifestHmacKey) {
+    NDN_LOG_ERROR("Received HMAC signed data: " << data.getName() << " but no HMAC key is loaded");
+    return false;
+  }
+
+  return subscriber::verifyHmacSignature(data, *m_manifestHmacKey);
+}
+
 void
 Subscriber::onTimeout(const ndn::Interest& interest)
 {
@@ -196,21 +224,25 @@ Subscriber::onTimeout(const ndn::Interest& interest)
 void
 Subscriber::subscribe(ndn::Name& streamName)
 {
+  auto groupPrefix = getSyncGroupPrefix(m_syncPrefix, streamName);
+  auto& group = joinSyncGroup(groupPrefix);
+
   // convert the streamName into manifest, because that's what is published by the sync
   streamName.append("MANIFEST");
   auto it = m_availableStreams.find(streamName);
   if (it == m_availableStreams.end()) {
-    NDN_LOG_INFO("Stream: " << streamName << " not available for subscription");
-    // schedule a hello interest in next 200 milliseconds
-    m_scheduler.schedule(200_ms, [=] { m_psync_consumer.sendHelloInterest();});
+    // no polling, the stream is subscribed once a catalog version lists it
+    NDN_LOG_INFO("Stream: " << streamName << " not in the catalog yet, waiting for it");
+    m_waitingForCatalog.insert(streamName.getPrefix(-1));
     return;
   }
-  NDN_LOG_INFO("Sending subscription of " << streamName << " to sync");
-  m_psync_consumer.addSubscription(streamName, it->second);
-  // m_psync_consumer.sendSyncInterest(); // surprise why psync can't do this internally ??
+  NDN_LOG_INFO("Sending subscription of " << streamName << " to sync group: " << groupPrefix);
+  group.consumer->addSubscription(streamName, it->second);
+  // group.consumer->sendSyncInterest(); // surprise why psync can't do this internally ??
 
   // add to subscription list if not added earlier
   addToSubscriptionList(streamName);
+  scheduleSyncResize(groupPrefix);
 }
 
 void
@@ -228,12 +260,266 @@ Subscriber::unsubscribe(ndn::Name& streamName)
                                        streamName), m_subscriptionList.end());
 
   NDN_LOG_INFO("Unsubscribing to: " << streamName);
+  auto groupPrefix = getSyncGroupPrefix(m_syncPrefix, streamName);
   streamName.append("MANIFEST"); // sync uses streamName + manifest
-  m_psync_consumer.removeSubscription(streamName);
+  auto group = m_syncGroups.find(groupPrefix);
+  if (group == m_syncGroups.end())
+    return;
+  // the group stays joined, the stream is still eligible
+  group->second.consumer->removeSubscription(streamName);
+  scheduleSyncResize(groupPrefix);
+}
+
+Subscriber::SyncGroup&
+Subscriber::joinSyncGroup(const ndn::Name& groupPrefix)
+{
+  auto it = m_syncGroups.find(groupPrefix);
+  if (it != m_syncGroups.end())
+    return it->second;
+
+  NDN_LOG_INFO("Joining sync group: " << groupPrefix);
+  auto& group = m_syncGroups[groupPrefix];
+  group.capacity = SYNC_MIN_SUBSCRIPTIONS;
+  group.consumer = makeConsumer(groupPrefix, group.capacity);
+  group.consumer->sendHelloInterest();
+
+  // follow the version of the group, the top-level hello tells it if not known yet
+  auto version = m_groupVersions.find(groupPrefix);
+  if (version == m_groupVersions.end()) {
+    m_topLevel.consumer->sendHelloInterest();
+  }
+  else {
+    m_topLevel.consumer->addSubscription(groupPrefix, version->second);
+    m_topLevel.consumer->sendSyncInterest();
+  }
+  scheduleSyncResize(m_syncPrefix);
+  return group;
+}
+
+std::unique_ptr<psync::Consumer>
+Subscriber::makeConsumer(const ndn::Name& syncPrefix, size_t expectedSubscriptions)
+{
+  psync::ReceiveHelloCallback onHello;
+  psync::UpdateCallback onUpdate;
+  if (syncPrefix == m_syncPrefix) {
+    onHello = std::bind(&Subscriber::receivedGroupHello, this, _1);
+    onUpdate = std::bind(&Subscriber::receivedGroupUpdates, this, _1);
+  }
+  else {
+    onHello = std::bind(&Subscriber::receivedHelloData, this, syncPrefix, _1);
+    onUpdate = std::bind(&Subscriber::receivedSyncUpdates, this, _1);
+  }
+
+  // 1_s hello interest lifetime, SYNC_INTEREST_LIFETIME = 1600_ms sync interest life time
+  return std::make_unique<psync::Consumer>(syncPrefix, m_face, onHello, onUpdate,
+                                           expectedSubscriptions, SYNC_BLOOM_FPR, 1_s,
+                                           SYNC_INTEREST_LIFETIME);
 }
 
 void
-Subscriber::receivedHelloData(const std::map<ndn::Name, uint64_t>& availStreams)
+Subscriber::scheduleSyncResize(const ndn::Name& syncPrefix)
+{
+  // subscribe() also runs from the hello callback of the consumer, don't replace it from there
+  m_pendingResize.insert(syncPrefix);
+  if (m_syncResizeScheduled)
+    return;
+  m_syncResizeScheduled = true;
+  m_scheduler.schedule(0_ms, [this] {
+    m_syncResizeScheduled = false;
+    auto pending = std::move(m_pendingResize);
+    m_pendingResize.clear();
+    for (const auto& syncPrefix : pending)
+      resizeSyncState(syncPrefix);
+  });
+}
+
+void
+Subscriber::resizeSyncState(const ndn::Name& syncPrefix)
+{
+  auto& group = syncPrefix == m_syncPrefix ? m_topLevel : m_syncGroups.at(syncPrefix);
+  auto subscriptions = group.consumer->getSubscriptionList();
+  auto nSubscriptions = subscriptions.size();
+  bool isOutgrown = nSubscriptions > group.capacity;
+  bool isOversized = group.capacity > SYNC_MIN_SUBSCRIPTIONS && nSubscriptions * 4 < group.capacity;
+  if (!isOutgrown && !isOversized)
+    return;
+
+  auto expectedSubscriptions = getSyncStateSize(nSubscriptions, SYNC_MIN_SUBSCRIPTIONS);
+  NDN_LOG_INFO("Resizing bloom filter of: " << syncPrefix << " from: " << group.capacity
+               << " to: " << expectedSubscriptions << " subscriptions, subscribed: " << nSubscriptions);
+
+  std::map<ndn::Name, uint64_t> seqNos;
+  for (const auto& prefix : subscriptions)
+    seqNos.emplace(prefix, group.consumer->getSeqNo(prefix).value_or(0));
+
+  group.consumer->stop();
+  group.capacity = expectedSubscriptions;
+  group.consumer = makeConsumer(syncPrefix, group.capacity);
+  for (const auto& [prefix, seqNo] : seqNos)
+    group.consumer->addSubscription(prefix, seqNo);
+
+  // the new consumer has no IBF of the producer yet, sync interests follow the hello data
+  group.consumer->sendHelloInterest();
+}
+
+void
+Subscriber::scheduleHelloRefresh()
+{
+  m_helloRefreshEvent = m_scheduler.schedule(SYNC_HELLO_REFRESH_INTERVAL, [this] {
+    NDN_LOG_DEBUG("No group update for: " << SYNC_HELLO_REFRESH_INTERVAL << ", sending hello interest");
+    m_topLevel.consumer->sendHelloInterest();
+    scheduleHelloRefresh();
+  });
+}
+
+void
+Subscriber::receivedGroupHello(const std::map<ndn::Name, uint64_t>& groupVersions)
+{
+  for (const auto& [groupPrefix, version] : groupVersions) {
+    if (groupPrefix == m_catalogPrefix) {
+      m_topLevel.consumer->addSubscription(m_catalogPrefix, version);
+      onCatalogVersion(version);
+      continue;
+    }
+
+    auto known = m_groupVersions.find(groupPrefix);
+    bool isChanged = known != m_groupVersions.end() && known->second != version;
+    m_groupVersions[groupPrefix] = version;
+
+    auto group = m_syncGroups.find(groupPrefix);
+    if (group == m_syncGroups.end())
+      continue;
+    m_topLevel.consumer->addSubscription(groupPrefix, version);
+    // missed while the hello refresh was pending, or the producer restarted
+    if (isChanged)
+      group->second.consumer->sendHelloInterest();
+  }
+
+  m_topLevel.consumer->sendSyncInterest();
+}
+
+void
+Subscriber::receivedGroupUpdates(const std::vector<psync::MissingDataInfo>& updates)
+{
+  scheduleHelloRefresh();
+
+  for (const auto& update : updates) {
+    if (update.prefix == m_catalogPrefix) {
+      onCatalogVersion(update.highSeq);
+      continue;
+    }
+
+    NDN_LOG_DEBUG("Sync group: " << update.prefix << " version: " << update.highSeq);
+    m_groupVersions[update.prefix] = update.highSeq;
+    // new prefixes or a resized IBF, both come with the hello data of the group
+    auto group = m_syncGroups.find(update.prefix);
+    if (group != m_syncGroups.end())
+      group->second.consumer->sendHelloInterest();
+  }
+}
+
+void
+Subscriber::sendCatalogNotify()
+{
+  // versions announced but not fetched yet are known as well, otherwise the answer comes right back
+  auto knownVersion = std::max(m_catalog.version, m_latestCatalogVersion);
+  auto interestName = m_catalogPrefix;
+  interestName.append(CATALOG_NOTIFY_COMPONENT).appendNumber(knownVersion);
+
+  ndn::Interest interest(interestName);
+  interest.setCanBePrefix(false);
+  interest.setInterestLifetime(CATALOG_NOTIFY_LIFETIME);
+
+  auto retry = [this] (const std::string& reason) {
+    NDN_LOG_DEBUG("Catalog notification failed (" << reason << "), retrying in: " << m_notifyRetryDelay);
+    m_notifyRetryEvent = m_scheduler.schedule(m_notifyRetryDelay, [this] { sendCatalogNotify(); });
+    m_notifyRetryDelay = std::min(m_notifyRetryDelay * 2, CATALOG_NOTIFY_RETRY_MAX_DELAY);
+  };
+
+  m_face.expressInterest(interest,
+    [this, knownVersion, retry] (const ndn::Interest&, const ndn::Data& data) {
+      uint64_t version = 0;
+      try {
+        version = ndn::encoding::readNonNegativeInteger(data.getContent());
+      }
+      catch (const std::exception& e) {
+        retry(e.what());
+        return;
+      }
+      if (version <= knownVersion) {
+        retry("stale notification");
+        return;
+      }
+      m_notifyRetryDelay = CATALOG_NOTIFY_RETRY_MIN_DELAY;
+      onCatalogVersion(version);
+      sendCatalogNotify();
+    },
+    [retry] (const ndn::Interest&, const ndn::lp::Nack&) {
+      retry("nack");
+    },
+    // no new stream for the whole lifetime, the producer is there
+    [this] (const ndn::Interest&) {
+      m_notifyRetryDelay = CATALOG_NOTIFY_RETRY_MIN_DELAY;
+      sendCatalogNotify();
+    });
+}
+
+void
+Subscriber::onCatalogVersion(uint64_t version)
+{
+  m_latestCatalogVersion = std::max(m_latestCatalogVersion, version);
+  if (version <= m_catalog.version || m_fetchingCatalogVersions.count(version) > 0)
+    return;
+  m_fetchingCatalogVersions.insert(version);
+
+  auto catalogName = m_catalogPrefix;
+  catalogName.appendNumber(version);
+  NDN_LOG_DEBUG("Fetching stream catalog: " << catalogName);
+  fetchSegmented(catalogName, [this, version] (const ndn::ConstBufferPtr& content) {
+    m_fetchingCatalogVersions.erase(version);
+    manifest::StreamCatalog catalog;
+    try {
+      catalog.wireDecode(ndn::Block(content));
+    }
+    catch (const std::exception& e) {
+      NDN_LOG_ERROR("Invalid stream catalog: " << e.what());
+      return;
+    }
+    // fetches may complete out of order
+    if (catalog.version > m_catalog.version)
+      onCatalog(std::move(catalog));
+  },
+  // fetched again with the next announcement or notification
+  [this, version] { m_fetchingCatalogVersions.erase(version); });
+}
+
+void
+Subscriber::onCatalog(manifest::StreamCatalog&& catalog)
+{
+  NDN_LOG_INFO("Stream catalog version: " << catalog.version << " streams: " << catalog.streams.size());
+  m_catalog = std::move(catalog);
+
+  // listed streams can be subscribed before they published anything, their group hello has the rest
+  for (const auto& stream : m_catalog.streams) {
+    m_availableStreams.emplace(ndn::Name(stream).append("MANIFEST"), 0);
+  }
+
+  // the version is the time the first of its new streams showed up at the producer
+  auto appearedAt = ndn::time::fromUnixTimestamp(ndn::time::milliseconds(m_catalog.version));
+  auto waiting = std::move(m_waitingForCatalog);
+  m_waitingForCatalog.clear();
+  for (auto stream : waiting) {
+    if (m_catalog.streams.count(stream) > 0) {
+      auto latency = ndn::time::duration_cast<ndn::time::milliseconds>(ndn::time::system_clock::now() - appearedAt);
+      m_availabilityLatencies.push_back(latency);
+      NDN_LOG_INFO("Stream: " << stream << " subscribed " << latency << " after it appeared");
+    }
+    subscribe(stream);
+  }
+}
+
+void
+Subscriber::receivedHelloData(const ndn::Name& groupPrefix, const std::map<ndn::Name, uint64_t>& availStreams)
 {
   // store all the streams names and their latest seq number
   for (const auto& it: availStreams) {
@@ -243,48 +529,187 @@ Subscriber::receivedHelloData(const std::map<ndn::Name, uint64_t>& availStreams)
     // setHighSeqFetchedOfPrefix(it.first, it.second);
   }
 
-  // subscribe to streams present in the subscription list
-  for (auto stream : m_subscriptionList) { subscribe(stream); }
+  // subscribe to streams of this group present in the subscription list
+  for (auto stream : m_subscriptionList) {
+    if (getSyncGroupPrefix(m_syncPrefix, stream) == groupPrefix)
+      subscribe(stream);
+  }
 
-  m_psync_consumer.sendSyncInterest();
+  m_syncGroups.at(groupPrefix).consumer->sendSyncInterest();
 }
 
 void
 Subscriber::fetchABEData(const ndn::Name& name)
 {
   NDN_LOG_DEBUG("Fetching data using NAC-ABE for name: " << name);
-  m_abe_consumer.consume(name, bind(&Subscriber::abeOnData, this, _1, name),
-                         bind(&Subscriber::abeOnError, this, _1, name));
+  // application doesn't need to see the implicit digest
+  auto dataName = (!name.empty() && name.get(-1).isImplicitSha256Digest()) ? name.getPrefix(-1) : name;
+  m_abe_consumer.consume(name, bind(&Subscriber::abeOnData, this, _1, dataName),
+                         bind(&Subscriber::abeOnError, this, _1, dataName));
+}
+
+void
+Subscriber::fetchManifest(const ndn::Name& manifestName)
+{
+  NDN_LOG_DEBUG("Fetching manifest: " << manifestName);
+  fetchSegmented(manifestName, [this, manifestName] (const ndn::ConstBufferPtr& content) {
+    NDN_LOG_DEBUG("Manifest: " << manifestName << " fetched, size: " << content->size());
+    // segments carry the encoded mGuardPublisher block, wrap it as it is in a single data content
+    wireDecode(ndn::encoding::makeBinaryBlock(ndn::tlv::Content, content->begin(), content->end()));
+  });
+}
+
+void
+Subscriber::fetchSegmented(const ndn::Name& name, const std::function<void(const ndn::ConstBufferPtr&)>& onComplete,
+                           const std::function<void()>& onFailure)
+{
+  ndn::Interest interest(name);
+  interest.setCanBePrefix(true);
+
+  ndn::util::SegmentFetcher::Options options;
+  options.probeLatestVersion = false; // manifests and catalogs are never updated, take the version found first
+  options.initCwnd = MANIFEST_FETCH_WINDOW;
+
+  // each segment is validated before it is reassembled, a bad one fails the whole fetch
+  auto fetcher = ndn::util::SegmentFetcher::start(m_face, interest,
+                                                  m_hmacValidator ? static_cast<ndn::security::Validator&>(*m_hmacValidator)
+                                                                  : static_cast<ndn::security::Validator&>(m_validator),
+                                                  options);
+
+  fetcher->onComplete.connect(onComplete);
+
+  fetcher->onError.connect([name, onFailure] (uint32_t code, const std::string& msg) {
+    NDN_LOG_ERROR("Failed to fetch: " << name << " error: " << code << " " << msg);
+    if (onFailure)
+      onFailure();
+  });
+}
+
+void
+Subscriber::fetchRange(const ndn::Name& prefix, uint64_t from, uint64_t to)
+{
+  for (auto sc = from; sc <= to; sc++) { // sc = sequence counter
+    /* for each update (can be manifest or application prefix), we need to express 
+    interest and fetch the respective content */
+    NDN_LOG_INFO("Update: " << prefix << "/" << sc);
+    auto interestName = prefix;
+    
+    interestName.appendNumber(sc);
+    NDN_LOG_DEBUG("Request content for prefix: " << interestName);
+    
+    // check if this prefix is for MANIFEST or not
+    if (prefix.toUri().find("MANIFEST") != std::string::npos) {
+      fetchManifest(interestName);
+    } else {
+      fetchABEData(interestName);
+    }
+  }
 }
 
 void
 Subscriber::receivedSyncUpdates(const std::vector<psync::MissingDataInfo>& updates)
 {
   for (const auto& update : updates) {
+    auto pending = m_pendingCatchUp.find(update.prefix);
+    if (pending != m_pendingCatchUp.end()) {
+      // still looking up where to start, fetched once the index search is done
+      pending->second = std::max(pending->second, update.highSeq);
+      continue;
+    }
+
     auto lSeq = getHighSeqFetchedOfPrefix(update.prefix);
-    auto sc = (lSeq == NOT_AVAILABLE) ? STARTING_SEQ_NUM : lSeq; // sc = sequence counter
-
-    for (; sc <= update.highSeq; sc++) {
-      /* for each update (can be manifest or application prefix), we need to express 
-      interest and fetch the respective content */
-      NDN_LOG_INFO("Update: " << update.prefix << "/" << sc);
-      auto interestName = update.prefix;
-      
-      interestName.appendNumber(sc);
-      NDN_LOG_DEBUG("Request content for prefix: " << interestName);
-      
-      // check if this prefix is for MANIFEST or not
-      if ((update.prefix).toUri().find("MANIFEST") != std::string::npos) {
-        expressInterest(interestName, true);
-      } else {
-        fetchABEData(interestName);
+    auto sc = (lSeq == NOT_AVAILABLE) ? STARTING_SEQ_NUM : lSeq;
+
+    if (lSeq == NOT_AVAILABLE && m_catchUpMode == CatchUpMode::LIVE_TAIL) {
+      sc = update.highSeq;
+    }
+    else if (lSeq == NOT_AVAILABLE && m_catchUpMode == CatchUpMode::FROM_TIMESTAMP) {
+      auto indexPrefix = update.prefix;
+      indexPrefix.append("INDEX");
+      auto it = m_availableStreams.find(indexPrefix);
+      if (it != m_availableStreams.end() && it->second >= STARTING_SEQ_NUM) {
+        NDN_LOG_DEBUG("Searching index: " << indexPrefix << " for manifests since: "
+                      << ndn::time::toIsoString(m_catchUpTimestamp));
+        m_pendingCatchUp.emplace(update.prefix, update.highSeq);
+        searchManifestIndex(update.prefix, STARTING_SEQ_NUM, it->second, STARTING_SEQ_NUM, std::nullopt);
+        continue;
       }
+      // nothing indexed yet, the history is short
     }
+
+    fetchRange(update.prefix, sc, update.highSeq);
     // update lowSequnece number, set it to current high
     setHighSeqFetchedOfPrefix(update.prefix, update.highSeq+1);
   }
 }
 
+void
+Subscriber::searchManifestIndex(const ndn::Name& manifestPrefix, uint64_t lo, uint64_t hi,
+                                uint64_t startSeq, std::optional<uint64_t> foundSeq)
+{
+  auto finish = [this, manifestPrefix] (uint64_t from) {
+    auto it = m_pendingCatchUp.find(manifestPrefix);
+    if (it == m_pendingCatchUp.end())
+      return;
+    auto highSeq = it->second;
+    m_pendingCatchUp.erase(it);
+
+    NDN_LOG_INFO("Catching up: " << manifestPrefix << " from: " << from << " to: " << highSeq);
+    fetchRange(manifestPrefix, from, highSeq);
+    setHighSeqFetchedOfPrefix(manifestPrefix, std::max(from, highSeq + 1));
+  };
+
+  if (lo > hi) {
+    finish(foundSeq.value_or(startSeq));
+    return;
+  }
+
+  auto mid = lo + (hi - lo) / 2;
+  auto indexName = manifestPrefix;
+  indexName.append("INDEX").appendNumber(mid);
+  NDN_LOG_DEBUG("Fetching manifest index: " << indexName);
+
+  auto onIndex = [=] (const ndn::Data& data) {
+    manifest::ManifestIndex index;
+    try {
+      index.wireDecode(data.getContent().blockFromValue());
+    }
+    catch (const std::exception& e) {
+      NDN_LOG_ERROR("Invalid manifest index: " << data.getName() << " " << e.what());
+      finish(foundSeq.value_or(startSeq));
+      return;
+    }
+
+    if (index.endTime < m_catchUpTimestamp)
+      searchManifestIndex(manifestPrefix, mid + 1, hi, std::max(startSeq, index.lastSeq + 1), foundSeq);
+    else
+      searchManifestIndex(manifestPrefix, lo, mid - 1, startSeq, index.firstSeq);
+  };
+  // on failure, start at the earliest manifest that is known to be needed
+  auto onFailure = [=] (const std::string& reason) {
+    NDN_LOG_ERROR("Failed to fetch manifest index: " << indexName << " " << reason);
+    finish(startSeq);
+  };
+
+  ndn::Interest interest(indexName);
+  m_face.expressInterest(interest,
+    [=] (const ndn::Interest&, const ndn::Data& data) {
+      if (data.getSignatureType() == ndn::tlv::SignatureHmacWithSha256) {
+        if (verifyHmacSignature(data))
+          onIndex(data);
+        else
+          onFailure("invalid HMAC signature");
+        return;
+      }
+      m_validator.validate(data, onIndex,
+        [=] (const ndn::Data&, const ndn::security::ValidationError& error) {
+          onFailure(error.getInfo());
+        });
+    },
+    [=] (const ndn::Interest&, const ndn::lp::Nack&) { onFailure("nack"); },
+    [=] (const ndn::Interest&) { onFailure("timeout"); });
+}
+
 void
 Subscriber::wireDecode(const ndn::Block& wire)
 {
@@ -303,6 +728,9 @@ Subscriber::wireDecode(const ndn::Block& wire)
                                    ndn::to_string(it->type())));
       }
     }
+    // only the groups holding eligible streams are joined
+    for (const auto& stream : m_eligibleStreams)
+      joinSyncGroup(getSyncGroupPrefix(m_syncPrefix, stream));
     m_subCallback({m_eligibleStreams});
   }
 
@@ -310,17 +738,18 @@ Subscriber::wireDecode(const ndn::Block& wire)
     // If its matches mGuardPublisher tlv, it will be the manifest data because
     // publisher only creates manifest packets
     NDN_LOG_DEBUG ("Received data from publisher");
-    val->parse();
-    for (auto it = val->elements_begin(); it != val->elements_end(); ++it) {
-      if (it->type() == ndn::tlv::Name) {
-        ndn::Name dataName(*it);
-        NDN_LOG_DEBUG("Fetch data: " << dataName);
+    // compact entries are expanded into names only when fetched
+    manifest::ManifestEntries entries(*val);
+
+    for (size_t i = 0; i < entries.size(); ++i) {
+      auto dataName = entries.get(i);
+      NDN_LOG_DEBUG("Fetch data: " << dataName);
+      // manifest signature is already validated, fetching by full name (implicit digest)
+      // only the packet listed in the manifest can satisfy the interest
+      if (USE_MANIFEST_DIGEST_AUTH)
+        fetchABEData(dataName);
+      else
         fetchABEData(dataName.getPrefix(-1));
-      }
-      else {
-        NDN_THROW(ndn::tlv::Error("Expected Name element, but TLV has type " +
-                                   ndn::to_string(it->type())));
-      }
     }
   }
 }
@@ -20,6 +20,10 @@
 #ifndef MGUARD_SUBSCRIBER_HPP
 #define MGUARD_SUBSCRIBER_HPP
 
+#include "../common.hpp"
+#include "../manifest.hpp"
+#include "hmac-validator.hpp"
+
 #include <PSync/consumer.hpp>
 #include <nac-abe/attribute-authority.hpp>
 #include <nac-abe/consumer.hpp>
@@ -29,6 +33,9 @@
 #include <ndn-cxx/security/validator-config.hpp>
 
 #include <functional>
+#include <map>
+#include <set>
+#include <optional>
 #include <string>
 #include <chrono>
 #include <thread>
@@ -58,6 +65,14 @@ public:
   using std::runtime_error::runtime_error;
 };
 
+/*
+  Where to start fetching the manifests of a newly subscribed stream
+  FROM_BEGINNING: all the manifests, starting at STARTING_SEQ_NUM
+  LIVE_TAIL: only the latest manifest and newer ones
+  FROM_TIMESTAMP: manifests published since the given time, found via the manifest index
+*/
+enum class CatchUpMode { FROM_BEGINNING, LIVE_TAIL, FROM_TIMESTAMP };
+
 class Subscriber
 {
 public:
@@ -99,6 +114,16 @@ public:
     return m_subscriptionList;
   }
 
+  /**
+   * @brief Time from a stream showing up at the producer to its subscription, for the streams
+   *  subscribed before the catalog listed them. Producer and consumer clocks are assumed in sync.
+  */
+  const std::vector<ndn::time::milliseconds>&
+  getAvailabilityLatencies() const
+  {
+    return m_availabilityLatencies;
+  }
+
   /**
    * @brief This method adds a stream to the subscription list if not added already
    * @param name Data stream name
@@ -152,6 +177,20 @@ public:
     m_subscriptionList = subList;
   }
 
+  /**
+   * @brief Set where to start fetching streams the consumer subscribes to from now on,
+   *  streams already being fetched are not affected. Default is FROM_BEGINNING.
+   * @param mode catch up mode
+   * @param timestamp start time, only used with FROM_TIMESTAMP
+  */
+  void
+  setCatchUpMode(CatchUpMode mode,
+                 const ndn::time::system_clock::time_point& timestamp = ndn::time::system_clock::time_point())
+  {
+    m_catchUpMode = mode;
+    m_catchUpTimestamp = timestamp;
+  }
+
 public:
   /**
    * @brief Subscribe to a Data stream or a Manifest
@@ -190,6 +229,31 @@ private:
   void
   fetchABEData(const ndn::Name& name);
 
+  /**
+   * @brief Fetch all segments of a manifest (pipelined) and decode it once complete
+   * @param manifestName Manifest name with sequence number, i.e. without version and segment
+  */
+  void
+  fetchManifest(const ndn::Name& manifestName);
+
+  /**
+   * @brief Fetch manifests (or data) of a sync prefix from sequence number from to to (inclusive)
+  */
+  void
+  fetchRange(const ndn::Name& prefix, uint64_t from, uint64_t to);
+
+  /**
+   * @brief Find the first manifest published at or after m_catchUpTimestamp by binary searching
+   *  the index objects of the stream, in [lo, hi]. Manifests are fetched from there up to the
+   *  highest sequence number received via sync in the meantime.
+   * @param manifestPrefix /<stream>/MANIFEST
+   * @param startSeq manifests before this one are known to be published before the timestamp
+   * @param foundSeq first manifest of the earliest index found so far ending at or after the timestamp
+  */
+  void
+  searchManifestIndex(const ndn::Name& manifestPrefix, uint64_t lo, uint64_t hi,
+                      uint64_t startSeq, std::optional<uint64_t> foundSeq);
+
   /**
    * @brief Callback on expressInterest once the data is received
    *  The data can be from the mGuardController or mGuardPublisher
@@ -206,6 +270,14 @@ private:
   void
   onTimeout(const ndn::Interest& interest);
 
+  /**
+   * @brief Verify a manifest signed with the shared HMAC key (MANIFEST_SIGNER = HMAC).
+   *  HMAC signatures can't be checked by the trust schema, thus done here.
+   * @return true if the signature is valid
+  */
+  bool
+  verifyHmacSignature(const ndn::Data& data);
+
   /**
    * @brief Sync Callback after receiving hello data. 
    * @param availStreams Contains stream/manifest name as well as it 
@@ -213,7 +285,19 @@ private:
     @return 
   */
   void
-  receivedHelloData(const std::map<ndn::Name, uint64_t>& availStreams);
+  receivedHelloData(const ndn::Name& groupPrefix, const std::map<ndn::Name, uint64_t>& availStreams);
+
+  /**
+   * @brief Top-level sync callback after receiving hello data, holds the version of every group
+  */
+  void
+  receivedGroupHello(const std::map<ndn::Name, uint64_t>& groupVersions);
+
+  /**
+   * @brief Top-level sync callback, a joined group got new prefixes or a resized IBF
+  */
+  void
+  receivedGroupUpdates(const std::vector<psync::MissingDataInfo>& updates);
 
   /**
    * @brief Sync Callback after receiving sync data.
@@ -227,6 +311,63 @@ private:
   void
   wireDecode(const ndn::Block& wire);
 
+  /**
+   * @brief Keep a notification interest pending at the producer, answered once the catalog
+   *  has a version newer than the known one
+  */
+  void
+  sendCatalogNotify();
+
+  /**
+   * @brief Fetch a catalog version announced by the top-level group or a notification,
+   *  if newer than the one fetched
+  */
+  void
+  onCatalogVersion(uint64_t version);
+
+  void
+  onCatalog(manifest::StreamCatalog&& catalog);
+
+  /**
+   * @brief Fetch all the segments under a versioned name, validated as manifests are
+  */
+  void
+  fetchSegmented(const ndn::Name& name, const std::function<void(const ndn::ConstBufferPtr&)>& onComplete,
+                 const std::function<void()>& onFailure = nullptr);
+
+  struct SyncGroup
+  {
+    size_t capacity = 0; // expected number of subscriptions of the bloom filter
+    std::unique_ptr<psync::Consumer> consumer;
+  };
+
+  /**
+   * @brief Start syncing the group (see getSyncGroupPrefix) and following its version, if not yet
+  */
+  SyncGroup&
+  joinSyncGroup(const ndn::Name& groupPrefix);
+
+  // consumer of the top-level group if syncPrefix is the sync prefix, of a stream group otherwise
+  std::unique_ptr<psync::Consumer>
+  makeConsumer(const ndn::Name& syncPrefix, size_t expectedSubscriptions);
+
+  void
+  scheduleSyncResize(const ndn::Name& syncPrefix);
+
+  /**
+   * @brief Replace the consumer of a group by one whose bloom filter fits the subscriptions, if they
+   *  outgrew it or dropped below a quarter of it. Subscriptions keep their sequence numbers.
+  */
+  void
+  resizeSyncState(const ndn::Name& syncPrefix);
+
+  /**
+   * @brief Send a top-level hello interest if no group update arrives for SYNC_HELLO_REFRESH_INTERVAL,
+   *  sync interests carrying an IBF of an outdated size are not answered by the producer
+  */
+  void
+  scheduleHelloRefresh();
+
   // NAC-ABE callbacks
   void
   abeOnData(const ndn::Buffer& buffer, const ndn::Name& dataName);
@@ -252,9 +393,30 @@ private:
   std::unordered_map<ndn::Name, uint64_t> m_availableStreams; // name, sequence number
   std::unordered_set<ndn::Name> m_eligibleStreams;
   std::map<ndn::Name, int> m_retransmissionCount;
+  std::shared_ptr<HmacKey> m_manifestHmacKey;
+  std::unique_ptr<HmacValidator> m_hmacValidator; // for HMAC signed manifests, checked per segment
+
+  CatchUpMode m_catchUpMode = CatchUpMode::FROM_BEGINNING;
+  ndn::time::system_clock::time_point m_catchUpTimestamp;
+  // streams with index search in progress, highest sequence number received via sync meanwhile
+  std::unordered_map<ndn::Name, uint64_t> m_pendingCatchUp;
   ndn::nacabe::Consumer m_abe_consumer;
 
-  psync::Consumer m_psync_consumer;
+  // top-level group, subscribed to the versions of the joined groups
+  SyncGroup m_topLevel;
+  std::unordered_map<ndn::Name, uint64_t> m_groupVersions;
+  std::map<ndn::Name, SyncGroup> m_syncGroups; // joined groups
+  std::set<ndn::Name> m_pendingResize;
+  ndn::Name m_catalogPrefix;
+  manifest::StreamCatalog m_catalog;
+  std::set<ndn::Name> m_waitingForCatalog; // subscribed streams not listed by the catalog yet
+  uint64_t m_latestCatalogVersion = 0; // announced, maybe not fetched yet
+  std::set<uint64_t> m_fetchingCatalogVersions;
+  ndn::time::milliseconds m_notifyRetryDelay = CATALOG_NOTIFY_RETRY_MIN_DELAY;
+  ndn::scheduler::ScopedEventId m_notifyRetryEvent;
+  std::vector<ndn::time::milliseconds> m_availabilityLatencies;
+  bool m_syncResizeScheduled = false;
+  ndn::scheduler::ScopedEventId m_helloRefreshEvent;
   DataCallback m_ApplicationDataCallback;
   SubscriptionCallback m_subCallback;
 };
@@ -0,0 +1,229 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+  Heap allocations per published row on the store path of the publisher.
+
+  A row yields a data and a CK packet (built here up front, standing in for the output of
+  NAC-ABE), both are kept in the content cache and written to the repo through a RepoConnection
+  (to a local sink that discards the bytes), and the full name of the data goes into the
+  manifest list of the stream. The "copy" mode stores the packets the way the publisher used to
+  (cached by copy, std::bind write handler), the "shared" mode the way it does now.
+
+  Usage: publish-allocations [nRows]
+*/
+
+#include "common.hpp"
+#include "server/util/content-cache.hpp"
+#include "server/util/repo-connection.hpp"
+#include "server/util/stream.hpp"
+
+#include <ndn-cxx/security/key-chain.hpp>
+#include <ndn-cxx/security/signing-helpers.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <new>
+
+static std::atomic<uint64_t> g_nAllocations{0};
+
+void*
+operator new(std::size_t size)
+{
+  ++g_nAllocations;
+  if (void* p = std::malloc(size == 0 ? 1 : size))
+    return p;
+  throw std::bad_alloc();
+}
+
+void
+operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+void
+operator delete(void* p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+namespace mguard {
+namespace benchmarks {
+
+namespace ip = boost::asio::ip;
+
+// accepts connections and discards everything written to them
+class RepoSink
+{
+public:
+  explicit
+  RepoSink(boost::asio::io_service& io)
+    : m_io(io)
+    , m_acceptor(io, ip::tcp::endpoint(ip::address_v4::loopback(), 0))
+  {
+    accept();
+  }
+
+  std::string
+  getPort() const
+  {
+    return std::to_string(m_acceptor.local_endpoint().port());
+  }
+
+private:
+  void
+  accept()
+  {
+    m_sockets.emplace_back(m_io);
+    m_acceptor.async_accept(m_sockets.back(), [this] (const auto& err) {
+      if (err)
+        return;
+      read(m_sockets.back());
+      accept();
+    });
+  }
+
+  void
+  read(ip::tcp::socket& socket)
+  {
+    socket.async_read_some(boost::asio::buffer(m_buffer), [this, &socket] (const auto& err, size_t) {
+      if (!err)
+        read(socket);
+    });
+  }
+
+private:
+  boost::asio::io_service& m_io;
+  ip::tcp::acceptor m_acceptor;
+  std::list<ip::tcp::socket> m_sockets;
+  std::array<uint8_t, 64 * 1024> m_buffer;
+};
+
+struct Row
+{
+  std::shared_ptr<ndn::Data> data;
+  std::shared_ptr<ndn::Data> ckData;
+};
+
+class PublishBenchmark
+{
+public:
+  explicit
+  PublishBenchmark(size_t nRows)
+    : m_scheduler(m_io)
+    , m_keyChain("pib-memory:", "tpm-memory:")
+    , m_sink(m_io)
+    , m_streamName("/ndn/org/md2k/mguard/dd40c/phone/gps")
+  {
+    // the CK is shared by the rows encrypted with the same attributes
+    auto ckData = makePacket(ndn::Name(m_streamName).append("CK").appendNumber(0), 300);
+    for (size_t i = 0; i < nRows; ++i) {
+      m_rows.push_back(Row{makePacket(ndn::Name(m_streamName).appendNumber(i), 200), ckData});
+    }
+  }
+
+  // allocations per row
+  double
+  run(bool isShared)
+  {
+    util::ContentCache cache(m_scheduler, CONTENT_CACHE_CAPACITY, CONTENT_CACHE_TTL, CONTENT_CACHE_STORED_GRACE);
+    util::RepoConnection connection(m_io, REPO_WRITE_BATCH_BYTES, REPO_WRITE_MAX_DELAY);
+    util::Stream stream(m_streamName);
+
+    bool isConnected = false;
+    connection.connect({"127.0.0.1", m_sink.getPort()}, [&] (const auto&) { isConnected = true; });
+    while (!isConnected)
+      m_io.run_one();
+
+    size_t nWritten = 0;
+    util::AsyncWriteHandler onWritten = [&nWritten] (const auto&, const auto&) { ++nWritten; };
+
+    auto nBefore = g_nAllocations.load();
+    for (const auto& row : m_rows) {
+      for (const auto& packet : {row.ckData, row.data}) {
+        if (isShared) {
+          connection.write(packet->wireEncode(), packet->getName(), onWritten);
+          cache.insert(packet);
+        }
+        else {
+          cache.insert(*packet);
+          connection.write(packet->wireEncode(), packet->getName(),
+                           std::bind(&PublishBenchmark::onWritten, &nWritten,
+                                     std::placeholders::_1, std::placeholders::_2));
+        }
+      }
+      if (stream.updateManifestList(row.data->getFullName()))
+        stream.resetManifestList();
+      m_io.poll();
+    }
+    while (nWritten < 2 * m_rows.size())
+      m_io.run_one();
+    auto nAllocations = g_nAllocations.load() - nBefore;
+
+    return static_cast<double>(nAllocations) / m_rows.size();
+  }
+
+private:
+  std::shared_ptr<ndn::Data>
+  makePacket(const ndn::Name& name, size_t contentSize)
+  {
+    auto data = std::make_shared<ndn::Data>(name);
+    std::vector<uint8_t> content(contentSize, 0xAB);
+    data->setContent(content);
+    m_keyChain.sign(*data, ndn::security::signingWithSha256());
+    data->getFullName(); // computed by the publisher either way, cached by the packet
+    return data;
+  }
+
+  static void
+  onWritten(size_t* nWritten, const ndn::Name&, const util::AsyncRepoError&)
+  {
+    ++*nWritten;
+  }
+
+private:
+  boost::asio::io_service m_io;
+  ndn::Scheduler m_scheduler;
+  ndn::KeyChain m_keyChain;
+  RepoSink m_sink;
+  ndn::Name m_streamName;
+  std::vector<Row> m_rows;
+};
+
+} // namespace benchmarks
+} // namespace mguard
+
+int
+main(int argc, char** argv)
+{
+  size_t nRows = argc > 1 ? std::stoul(argv[1]) : 100000;
+
+  mguard::benchmarks::PublishBenchmark benchmark(nRows);
+  auto copied = benchmark.run(false);
+  auto shared = benchmark.run(true);
+
+  std::cout << "rows: " << nRows << std::endl;
+  std::cout << "allocations per row (copy):   " << copied << std::endl;
+  std::cout << "allocations per row (shared): " << shared << std::endl;
+  return 0;
+}
@@ -0,0 +1,127 @@
+#include "../test-common.hpp"
+
+#include <server/util/abe-precompute-pool.hpp>
+
+using namespace ndn;
+
+namespace mguard {
+namespace util {
+namespace tests {
+
+using Attributes = std::vector<std::string>;
+
+const Attributes A{"attr-a"};
+const Attributes B{"attr-b"};
+const Attributes C{"attr-c", "attr-b"};
+const time::milliseconds IDLE_TIME(500);
+
+class AbePrecomputePoolFixture : public mguard::tests::IdentityTimeFixture
+{
+public:
+  AbePrecomputePoolFixture()
+    : scheduler(io)
+    , pool(scheduler, [this] (const Attributes& attributes) {
+        warmedUp.push_back(attributes);
+        if (doThrow)
+          NDN_THROW(std::runtime_error("no public parameters"));
+        return canWarmUp;
+      }, IDLE_TIME)
+  {
+  }
+
+public:
+  Scheduler scheduler;
+  AbePrecomputePool pool;
+  std::vector<Attributes> warmedUp; // every attempt, in order
+  bool canWarmUp = true;
+  bool doThrow = false;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestAbePrecomputePool, AbePrecomputePoolFixture)
+
+BOOST_AUTO_TEST_CASE(LruOrder)
+{
+  pool.addExpectedAttributes(A);
+  pool.addExpectedAttributes(B);
+  pool.addExpectedAttributes(C);
+  pool.addExpectedAttributes(B);
+  // used right away, nothing left to prepare
+  pool.recordUse(A);
+  BOOST_CHECK_EQUAL(pool.getTrackedSize(), 3);
+  BOOST_CHECK_EQUAL(pool.getPoolSize(), 1);
+
+  advanceClocks(time::milliseconds(10), 100);
+  BOOST_REQUIRE_EQUAL(warmedUp.size(), 2);
+  BOOST_CHECK(warmedUp[0] == B);
+  BOOST_CHECK(warmedUp[1] == C);
+  BOOST_CHECK_EQUAL(pool.getPoolSize(), 3);
+
+  // warm sets are not prepared again
+  pool.addExpectedAttributes(C);
+  advanceClocks(time::milliseconds(10), 100);
+  BOOST_CHECK_EQUAL(warmedUp.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(WaitForIdle)
+{
+  pool.addExpectedAttributes(A);
+  advanceClocks(time::milliseconds(400));
+  // activity pushes the warm-up back
+  pool.recordUse(B);
+  advanceClocks(time::milliseconds(400));
+  BOOST_CHECK(warmedUp.empty());
+  advanceClocks(time::milliseconds(100));
+  BOOST_REQUIRE_EQUAL(warmedUp.size(), 1);
+  BOOST_CHECK(warmedUp[0] == A);
+}
+
+BOOST_AUTO_TEST_CASE(WarmUpRetry)
+{
+  canWarmUp = false;
+  pool.addExpectedAttributes(A);
+  advanceClocks(IDLE_TIME);
+  BOOST_CHECK_EQUAL(warmedUp.size(), 1);
+  BOOST_CHECK_EQUAL(pool.getPoolSize(), 0);
+  // used in the meantime, produced by the caller
+  BOOST_CHECK(!pool.recordUse(B));
+
+  // tried again after the next idle period
+  doThrow = true;
+  advanceClocks(IDLE_TIME);
+  BOOST_CHECK_EQUAL(warmedUp.size(), 2);
+  BOOST_CHECK_EQUAL(pool.getPoolSize(), 1); // B
+
+  doThrow = false;
+  canWarmUp = true;
+  advanceClocks(IDLE_TIME);
+  BOOST_CHECK_EQUAL(warmedUp.size(), 3);
+  BOOST_CHECK_EQUAL(pool.getPoolSize(), 2);
+
+  advanceClocks(IDLE_TIME, 4);
+  BOOST_CHECK_EQUAL(warmedUp.size(), 3);
+  BOOST_CHECK(pool.recordUse(A));
+}
+
+BOOST_AUTO_TEST_CASE(HitRate)
+{
+  BOOST_CHECK_EQUAL(pool.getHitRate(), 0.0);
+
+  BOOST_CHECK(!pool.recordUse(A));
+  BOOST_CHECK(pool.recordUse(A));
+  pool.addExpectedAttributes(B);
+  advanceClocks(IDLE_TIME);
+  BOOST_CHECK(pool.recordUse(B));
+  // same attributes in another order are another set
+  BOOST_CHECK(!pool.recordUse({"attr-b", "attr-c"}));
+
+  BOOST_CHECK_EQUAL(pool.getHitCount(), 2);
+  BOOST_CHECK_EQUAL(pool.getMissCount(), 2);
+  BOOST_CHECK_EQUAL(pool.getHitRate(), 0.5);
+  BOOST_CHECK(warmedUp.size() == 1 && warmedUp[0] == B);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace util
+} // namespace mguard
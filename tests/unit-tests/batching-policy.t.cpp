@@ -0,0 +1,70 @@
+#include "../test-common.hpp"
+
+#include <server/util/batching-policy.hpp>
+#include <common.hpp>
+
+using namespace ndn;
+using namespace ndn::time_literals;
+
+namespace mguard {
+namespace util {
+namespace tests {
+
+BOOST_FIXTURE_TEST_SUITE(TestBatchingPolicy, mguard::tests::IdentityTimeFixture)
+
+BOOST_AUTO_TEST_CASE(CountAndByteLimits)
+{
+  BatchingPolicy policy(3, 100, 1000_ms, 100_ms);
+
+  BOOST_CHECK(!policy.onAppend(10));
+  BOOST_CHECK(!policy.onAppend(10));
+  BOOST_CHECK(policy.onAppend(10)); // count limit
+  policy.onFlush();
+  BOOST_CHECK_EQUAL(policy.getBatchCount(), 0);
+
+  BOOST_CHECK(!policy.onAppend(60));
+  BOOST_CHECK(policy.onAppend(60)); // byte limit
+}
+
+BOOST_AUTO_TEST_CASE(AgeLimit)
+{
+  BatchingPolicy policy(50, 6000, 250_ms, 100_ms);
+
+  BOOST_CHECK(!policy.onAppend(10));
+  BOOST_CHECK_EQUAL(policy.getFlushDelay(), 100_ms); // idle time
+
+  advanceClocks(10_ms, 200_ms);
+  BOOST_CHECK(!policy.onAppend(10));
+  BOOST_CHECK_EQUAL(policy.getFlushDelay(), 50_ms); // oldest entry reaches max age first
+
+  advanceClocks(10_ms, 50_ms);
+  BOOST_CHECK(policy.onAppend(10));
+}
+
+BOOST_AUTO_TEST_CASE(Adaptive)
+{
+  auto policy = BatchingPolicy::makeAdaptive(500_ms, 1, 50, 6000, 100_ms);
+
+  // low rate stream, every entry is published right away
+  BOOST_CHECK(policy.onAppend(10));
+  policy.onFlush();
+  advanceClocks(100_ms, 10);
+  BOOST_CHECK(policy.onAppend(10));
+  policy.onFlush();
+
+  // 50 Hz stream, about 25 entries per manifest for 500 ms target latency
+  auto fast = BatchingPolicy::makeAdaptive(500_ms, 1, 50, 6000, 100_ms);
+  for (int i = 0; i < 200; ++i) {
+    if (fast.onAppend(10))
+      fast.onFlush();
+    advanceClocks(20_ms);
+  }
+  BOOST_CHECK_CLOSE(fast.getArrivalRate(), 50, 1);
+  BOOST_CHECK_EQUAL(fast.getTargetCount(), 25);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestBatchingPolicy
+
+} // tests
+} // util
+} // mguard
@@ -0,0 +1,50 @@
+#include "../test-common.hpp"
+
+#include <server/util/buffer-pool.hpp>
+
+#include <ndn-cxx/encoding/block.hpp>
+
+using namespace ndn;
+
+namespace mguard {
+namespace util {
+namespace tests {
+
+BOOST_FIXTURE_TEST_SUITE(TestBufferPool, mguard::tests::IdentityTimeFixture)
+
+BOOST_AUTO_TEST_CASE(Reuse)
+{
+  BufferPool pool(2);
+  std::vector<uint8_t> bytes{1, 2, 3, 4};
+
+  auto first = pool.acquire(bytes.data(), bytes.data() + bytes.size());
+  BOOST_CHECK_EQUAL_COLLECTIONS(first->begin(), first->end(), bytes.begin(), bytes.end());
+  const auto* firstBuffer = first.get();
+  first.reset();
+
+  // released, handed out again with the new content
+  auto second = pool.acquire(bytes.data(), bytes.data() + 2);
+  BOOST_CHECK_EQUAL(second.get(), firstBuffer);
+  BOOST_CHECK_EQUAL(second->size(), 2);
+  BOOST_CHECK_EQUAL(pool.getReuseCount(), 1);
+  BOOST_CHECK_EQUAL(pool.getAllocationCount(), 1);
+
+  // a block still refers to the buffer, it is not touched
+  Block content(ndn::tlv::Content, second);
+  second.reset();
+  auto third = pool.acquire(bytes.data(), bytes.data() + bytes.size());
+  BOOST_CHECK_NE(third.get(), firstBuffer);
+  BOOST_CHECK_EQUAL(content.value_size(), 2);
+  BOOST_CHECK_EQUAL(pool.size(), 2);
+
+  // the pool is full, buffers beyond it are not kept
+  auto fourth = pool.acquire(bytes.data(), bytes.data() + bytes.size());
+  BOOST_CHECK_EQUAL(pool.size(), 2);
+  BOOST_CHECK_EQUAL(pool.getAllocationCount(), 3);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace util
+} // namespace mguard
@@ -0,0 +1,123 @@
+#include "../test-common.hpp"
+
+#include <common.hpp>
+#include <server/util/checkpoint.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+
+using namespace ndn;
+
+namespace mguard {
+namespace util {
+namespace tests {
+
+class CheckpointFixture : public mguard::tests::IdentityTimeFixture
+{
+public:
+  CheckpointFixture()
+    : path(boost::filesystem::path(TMP_TESTS_PATH) / "producer.checkpoint")
+  {
+    boost::filesystem::create_directories(path.parent_path());
+    boost::filesystem::remove(path);
+  }
+
+  ~CheckpointFixture()
+  {
+    boost::filesystem::remove(path);
+  }
+
+public:
+  boost::filesystem::path path;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestCheckpoint, CheckpointFixture)
+
+BOOST_AUTO_TEST_CASE(EncodeDecode)
+{
+  StreamCheckpoint state;
+  state.streamName = "/ndn/org/md2k/mguard/dd40c/phone/battery";
+  state.manifestSeq = 42;
+  state.indexSeq = 3;
+  state.lastPublished = time::fromUnixTimestamp(time::milliseconds(1600000000000));
+  state.openIndex = manifest::ManifestIndex{*state.lastPublished, *state.lastPublished, 40, 42};
+  state.pendingEntries = {"/ndn/org/md2k/mguard/dd40c/phone/battery/DATA/20190901233459",
+                          "/ndn/org/md2k/mguard/dd40c/phone/battery/DATA/20190901233500"};
+
+  StreamCheckpoint decoded;
+  decoded.wireDecode(state.wireEncode());
+  BOOST_CHECK_EQUAL(decoded.streamName, state.streamName);
+  BOOST_CHECK_EQUAL(decoded.manifestSeq, 42);
+  BOOST_CHECK_EQUAL(decoded.indexSeq, 3);
+  BOOST_REQUIRE(decoded.lastPublished);
+  BOOST_CHECK(*decoded.lastPublished == *state.lastPublished);
+  BOOST_REQUIRE(decoded.openIndex);
+  BOOST_CHECK_EQUAL(decoded.openIndex->firstSeq, 40);
+  BOOST_CHECK_EQUAL(decoded.openIndex->lastSeq, 42);
+  BOOST_CHECK_EQUAL_COLLECTIONS(decoded.pendingEntries.begin(), decoded.pendingEntries.end(),
+                                state.pendingEntries.begin(), state.pendingEntries.end());
+
+  // a fresh stream only has the sequence numbers
+  StreamCheckpoint fresh;
+  fresh.streamName = "/ndn/org/md2k/mguard/dd40c/phone/gps";
+  decoded.wireDecode(fresh.wireEncode());
+  BOOST_CHECK(!decoded.lastPublished);
+  BOOST_CHECK(!decoded.openIndex);
+  BOOST_CHECK(decoded.pendingEntries.empty());
+}
+
+BOOST_AUTO_TEST_CASE(SaveAndLoad)
+{
+  std::vector<StreamCheckpoint> streams(2);
+  streams[0].streamName = "/stream/a";
+  streams[0].manifestSeq = 7;
+  streams[1].streamName = "/stream/b";
+  streams[1].pendingEntries = {"/stream/b/DATA/1"};
+
+  Checkpoint checkpoint(io, path.string(), [&] { return streams; });
+  BOOST_CHECK(checkpoint.load().empty());
+
+  checkpoint.save();
+  auto loaded = checkpoint.load();
+  BOOST_REQUIRE_EQUAL(loaded.size(), 2);
+  BOOST_CHECK_EQUAL(loaded[0].manifestSeq, 7);
+  BOOST_CHECK_EQUAL(loaded[1].pendingEntries.size(), 1);
+
+  // updates within the save interval are written once
+  streams[0].manifestSeq = 8;
+  checkpoint.saveLater();
+  advanceClocks(CHECKPOINT_SAVE_INTERVAL / 2);
+  streams[0].manifestSeq = 9;
+  checkpoint.saveLater();
+  BOOST_CHECK_EQUAL(checkpoint.load()[0].manifestSeq, 7);
+  advanceClocks(CHECKPOINT_SAVE_INTERVAL / 2);
+  BOOST_CHECK_EQUAL(checkpoint.load()[0].manifestSeq, 9);
+
+  // flushed before the scheduled write runs, which is cancelled
+  streams[0].manifestSeq = 10;
+  checkpoint.saveLater();
+  checkpoint.flush();
+  BOOST_CHECK_EQUAL(checkpoint.load()[0].manifestSeq, 10);
+  streams[0].manifestSeq = 11;
+  advanceClocks(CHECKPOINT_SAVE_INTERVAL);
+  BOOST_CHECK_EQUAL(checkpoint.load()[0].manifestSeq, 10);
+
+  // nothing to write
+  checkpoint.flush();
+  BOOST_CHECK_EQUAL(checkpoint.load()[0].manifestSeq, 10);
+  BOOST_CHECK(!boost::filesystem::exists(path.string() + ".tmp"));
+
+  // a corrupted checkpoint is ignored
+  {
+    std::ofstream os(path.string(), std::ios::binary | std::ios::trunc);
+    os << "garbage";
+  }
+  BOOST_CHECK(checkpoint.load().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestCheckpoint
+
+} // tests
+} // util
+} // mguard
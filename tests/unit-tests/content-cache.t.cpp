@@ -0,0 +1,106 @@
+#include "../test-common.hpp"
+
+#include <server/util/content-cache.hpp>
+
+#include <ndn-cxx/security/signing-helpers.hpp>
+
+using namespace ndn;
+using namespace ndn::time_literals;
+
+namespace mguard {
+namespace util {
+namespace tests {
+
+class ContentCacheFixture : public mguard::tests::IdentityTimeFixture
+{
+public:
+  ContentCacheFixture()
+    : scheduler(io)
+  {
+  }
+
+  Data
+  makeData(const Name& name, size_t contentSize = 10)
+  {
+    Data data(name);
+    std::vector<uint8_t> content(contentSize, 0xAB);
+    data.setContent(content);
+    m_keyChain.sign(data, security::signingWithSha256());
+    return data;
+  }
+
+public:
+  Scheduler scheduler;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestContentCache, ContentCacheFixture)
+
+BOOST_AUTO_TEST_CASE(Lookup)
+{
+  ContentCache cache(scheduler, 1024 * 1024, 10_s, 1_s);
+  auto data = makeData("/ndn/org/md2k/mguard/dd40c/phone/battery/DATA/1");
+  cache.insert(data);
+  cache.insert(makeData("/ndn/org/md2k/mguard/dd40c/phone/battery/MANIFEST/1/v=1/seg=0"));
+  BOOST_CHECK_EQUAL(cache.size(), 2);
+
+  BOOST_CHECK(cache.find(Interest(data.getName())) != nullptr);
+  BOOST_CHECK(cache.find(Interest(data.getFullName())) != nullptr);
+
+  auto wrongDigest = data.getName();
+  wrongDigest.appendImplicitSha256Digest(std::vector<uint8_t>(32, 0));
+  BOOST_CHECK(cache.find(Interest(wrongDigest)) == nullptr);
+
+  Interest prefixInterest("/ndn/org/md2k/mguard/dd40c/phone/battery/MANIFEST/1");
+  BOOST_CHECK(cache.find(prefixInterest) == nullptr);
+  prefixInterest.setCanBePrefix(true);
+  auto found = cache.find(prefixInterest);
+  BOOST_REQUIRE(found != nullptr);
+  BOOST_CHECK_EQUAL(found->getName().size(), 11);
+
+  BOOST_CHECK_EQUAL(cache.getHitCount(), 3);
+  BOOST_CHECK_EQUAL(cache.getMissCount(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(Expiry)
+{
+  ContentCache cache(scheduler, 1024 * 1024, 10_s, 1_s);
+  auto stored = makeData("/stored");
+  auto pending = makeData("/pending");
+  cache.insert(stored);
+  cache.insert(pending);
+
+  // repo has the packet, kept only for the grace period
+  cache.markStored(stored.getName());
+  advanceClocks(100_ms, 2_s);
+  BOOST_CHECK(cache.find(Interest("/stored")) == nullptr);
+  BOOST_CHECK(cache.find(Interest("/pending")) != nullptr);
+  BOOST_CHECK_EQUAL(cache.size(), 1);
+
+  advanceClocks(100_ms, 9_s);
+  BOOST_CHECK_EQUAL(cache.size(), 0);
+  BOOST_CHECK_EQUAL(cache.getBytes(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Capacity)
+{
+  auto first = makeData("/a", 400);
+  ContentCache cache(scheduler, first.wireEncode().size() * 2, 10_s, 1_s);
+  cache.insert(first);
+  cache.insert(makeData("/b", 400));
+
+  // refresh /a, /b is least recently used now
+  BOOST_CHECK(cache.find(Interest("/a")) != nullptr);
+  cache.insert(makeData("/c", 400));
+
+  BOOST_CHECK_EQUAL(cache.size(), 2);
+  BOOST_CHECK(cache.find(Interest("/b")) == nullptr);
+  BOOST_CHECK(cache.find(Interest("/a")) != nullptr);
+  BOOST_CHECK(cache.find(Interest("/c")) != nullptr);
+  BOOST_CHECK_LE(cache.getBytes(), first.wireEncode().size() * 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestContentCache
+
+} // tests
+} // util
+} // mguard
@@ -55,6 +55,43 @@ BOOST_AUTO_TEST_CASE(Constructor)
     }
 }
 
+BOOST_AUTO_TEST_CASE(ExpireByInsertionTime)
+{
+    std::string dbname = "test-expire.db";
+    db::DataBase db(dbname);
+    // historical study data, far older than the TTL
+    db.insertRows({"0,2019-09-01 18:34:59,2019-09-01 23:34:59,\"Row(_1=datetime.datetime(2019, 9, 1, 11, 34, 59), _2=datetime.datetime(2019, 9, 1, 13, 34, 59))\",shopping-mall,dd40c,1"});
+
+    // as DataAdapter::expireLookupRows does it
+    auto ttl = time::hours(1);
+    auto expire = [&] {
+      auto cutoff = time::toUnixTimestamp(time::system_clock::now() - ttl).count();
+      db.deleteRows("inserted < " + std::to_string(cutoff));
+    };
+
+    // kept for the TTL after the insertion
+    expire();
+    BOOST_CHECK_EQUAL(db.getSemanticLocations("20190901120000").size(), 1);
+
+    advanceClocks(time::minutes(61));
+    expire();
+    BOOST_CHECK(db.getSemanticLocations("20190901120000").empty());
+}
+
+BOOST_AUTO_TEST_CASE(DataNameCarriesMetadataVersion)
+{
+    util::MetadataVersions versions;
+    auto version = versions.prepare(0, "{\"name\": \"gps\"}");
+    BOOST_REQUIRE(version);
+    versions.commit(0, *version);
+
+    auto dataName = DataAdapter::makeDataName("/ndn/org/md2k/mguard/dd40c/phone/gps", "20190901113459",
+                                              versions.getVersion(0));
+    BOOST_CHECK_EQUAL(dataName.getPrefix(-1), Name("/ndn/org/md2k/mguard/dd40c/phone/gps/DATA/20190901113459"));
+    BOOST_REQUIRE(dataName.get(-1).isVersion());
+    BOOST_CHECK_EQUAL(dataName.get(-1).toVersion(), *version);
+}
+
 BOOST_AUTO_TEST_SUITE_END() //TestDataAdapter
 
 } // tests
@@ -0,0 +1,134 @@
+#include "../test-common.hpp"
+
+#include <user/hmac-validator.hpp>
+
+#include <ndn-cxx/util/dummy-client-face.hpp>
+#include <ndn-cxx/util/segment-fetcher.hpp>
+
+#include <optional>
+
+using namespace ndn;
+
+namespace mguard {
+namespace subscriber {
+namespace tests {
+
+const std::string HMAC_KEY = "AAECAwQFBgcICQoLDA0ODxAREhMUFRYXGBkaGxwdHh8=";
+const std::string OTHER_HMAC_KEY = "ZGVmZ2hpamtsbW5vcHFyc3R1dnd4eXp7fH1+f4CBgoM=";
+
+class HmacValidatorFixture : public mguard::tests::IdentityTimeFixture
+{
+public:
+  HmacValidatorFixture()
+    : face(io, m_keyChain)
+    , key(makeHmacKey(HMAC_KEY))
+    , validator(key)
+  {
+    // serve the segments of the catalog
+    face.onSendInterest.connect([this] (const Interest& interest) {
+      for (const auto& segment : segments) {
+        if (interest.matchesData(segment)) {
+          io.post([this, segment] { face.receive(segment); });
+          return;
+        }
+      }
+    });
+  }
+
+  Data
+  makeSegment(uint64_t segmentNo, uint64_t lastSegmentNo, const std::string& hmacKey)
+  {
+    Data segment(Name("/ndn/org/md2k/mguard/producer/CATALOG").appendVersion(1).appendSegment(segmentNo));
+    segment.setContent(std::vector<uint8_t>(10, static_cast<uint8_t>(segmentNo)));
+    segment.setFinalBlock(name::Component::fromSegment(lastSegmentNo));
+    m_keyChain.sign(segment, security::SigningInfo().setSigningHmacKey(hmacKey));
+    return segment;
+  }
+
+  // fetch the catalog as the subscriber does
+  void
+  fetch()
+  {
+    Interest interest("/ndn/org/md2k/mguard/producer/CATALOG");
+    interest.setCanBePrefix(true);
+    util::SegmentFetcher::Options options;
+    options.probeLatestVersion = false;
+
+    auto fetcher = util::SegmentFetcher::start(face, interest, validator, options);
+    fetcher->onComplete.connect([this] (const ConstBufferPtr& content) { fetched = content; });
+    fetcher->onError.connect([this] (uint32_t code, const std::string&) { errorCode = code; });
+    advanceClocks(time::milliseconds(10), 100);
+  }
+
+public:
+  ndn::util::DummyClientFace face;
+  std::shared_ptr<HmacKey> key;
+  HmacValidator validator;
+  std::vector<Data> segments;
+  ConstBufferPtr fetched;
+  std::optional<uint32_t> errorCode;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestHmacValidator, HmacValidatorFixture)
+
+BOOST_AUTO_TEST_CASE(Verify)
+{
+  auto segment = makeSegment(0, 0, HMAC_KEY);
+  BOOST_CHECK(verifyHmacSignature(segment, *key));
+  BOOST_CHECK(!verifyHmacSignature(makeSegment(0, 0, OTHER_HMAC_KEY), *key));
+
+  // content changed after signing
+  auto tampered = segment;
+  tampered.setContent(std::vector<uint8_t>(10, 0xFF));
+  BOOST_CHECK(!verifyHmacSignature(tampered, *key));
+
+  // same signature value length, but not an HMAC signature
+  Data digestSigned(segment.getName());
+  m_keyChain.sign(digestSigned, security::signingWithSha256());
+  BOOST_CHECK(!verifyHmacSignature(digestSigned, *key));
+
+  size_t nValid = 0;
+  size_t nInvalid = 0;
+  for (const auto& data : {segment, tampered, digestSigned}) {
+    validator.validate(data,
+                       [&] (const Data&) { ++nValid; },
+                       [&] (const Data&, const security::ValidationError&) { ++nInvalid; });
+  }
+  advanceClocks(time::milliseconds(10));
+  BOOST_CHECK_EQUAL(nValid, 1);
+  BOOST_CHECK_EQUAL(nInvalid, 2);
+}
+
+BOOST_AUTO_TEST_CASE(FetchSegments)
+{
+  segments = {makeSegment(0, 1, HMAC_KEY), makeSegment(1, 1, HMAC_KEY)};
+  fetch();
+  BOOST_CHECK(!errorCode);
+  BOOST_REQUIRE(fetched);
+  BOOST_CHECK_EQUAL(fetched->size(), 20);
+}
+
+BOOST_AUTO_TEST_CASE(ForgedLastSegment)
+{
+  // the forged segment completes the fetch, it must not be reassembled
+  segments = {makeSegment(0, 1, HMAC_KEY), makeSegment(1, 1, OTHER_HMAC_KEY)};
+  fetch();
+  BOOST_CHECK(!fetched);
+  BOOST_REQUIRE(errorCode);
+  BOOST_CHECK_EQUAL(*errorCode, util::SegmentFetcher::SEGMENT_VALIDATION_FAIL);
+}
+
+BOOST_AUTO_TEST_CASE(ForgedSingleSegment)
+{
+  segments = {makeSegment(0, 0, OTHER_HMAC_KEY)};
+  fetch();
+  BOOST_CHECK(!fetched);
+  BOOST_REQUIRE(errorCode);
+  BOOST_CHECK_EQUAL(*errorCode, util::SegmentFetcher::SEGMENT_VALIDATION_FAIL);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace subscriber
+} // namespace mguard
@@ -0,0 +1,207 @@
+#include "../test-common.hpp"
+
+#include <server/repo/log-store.hpp>
+#include <server/repo/retention-policy.hpp>
+
+#include <ndn-cxx/security/signing-helpers.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+
+using namespace ndn;
+
+namespace mguard {
+namespace repo {
+namespace tests {
+
+class LogStoreFixture : public mguard::tests::IdentityTimeFixture
+{
+public:
+  LogStoreFixture()
+    : path(boost::filesystem::path(TMP_TESTS_PATH) / "log-store")
+  {
+    boost::filesystem::remove_all(path);
+  }
+
+  ~LogStoreFixture()
+  {
+    boost::filesystem::remove_all(path);
+  }
+
+  Data
+  makeData(const Name& name, size_t contentSize = 100)
+  {
+    Data data(name);
+    std::vector<uint8_t> content(contentSize, 0xAB);
+    data.setContent(content);
+    m_keyChain.sign(data, security::signingWithSha256());
+    return data;
+  }
+
+public:
+  boost::filesystem::path path;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestLogStore, LogStoreFixture)
+
+BOOST_AUTO_TEST_CASE(InsertAndFind)
+{
+  LogStore store(path.string(), 1024 * 1024);
+  auto data = makeData("/ndn/org/md2k/mguard/dd40c/phone/battery/DATA/1");
+  store.insert(data);
+  store.insert(makeData("/ndn/org/md2k/mguard/dd40c/phone/battery/MANIFEST/1/v=1/seg=0"));
+  BOOST_CHECK_EQUAL(store.size(), 2);
+
+  auto found = store.find(Interest(data.getName()));
+  BOOST_REQUIRE(found != nullptr);
+  BOOST_CHECK(found->wireEncode() == data.wireEncode());
+  BOOST_CHECK(store.find(Interest(data.getFullName())) != nullptr);
+
+  Interest prefixInterest("/ndn/org/md2k/mguard/dd40c/phone/battery/MANIFEST/1");
+  BOOST_CHECK(store.find(prefixInterest) == nullptr);
+  prefixInterest.setCanBePrefix(true);
+  BOOST_CHECK(store.find(prefixInterest) != nullptr);
+  BOOST_CHECK(store.find(Interest("/ndn/org/md2k/mguard/dd40c/phone/gps").setCanBePrefix(true)) == nullptr);
+
+  // newer packet with the same name shadows the older one
+  auto newer = makeData(data.getName(), 50);
+  store.insert(newer);
+  BOOST_CHECK_EQUAL(store.size(), 2);
+  BOOST_CHECK(store.read(data.getName())->wireEncode() == newer.wireEncode());
+
+  BOOST_CHECK(store.erase(data.getName()));
+  BOOST_CHECK(!store.erase(data.getName()));
+  BOOST_CHECK(store.read(data.getName()) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(Recovery)
+{
+  std::vector<Data> packets;
+  {
+    // small segments, records are spread over several files
+    LogStore store(path.string(), 1000);
+    for (int i = 0; i < 20; ++i) {
+      packets.push_back(makeData(Name("/stream/DATA").appendNumber(i)));
+      store.insert(packets.back());
+    }
+    store.erase(packets[3].getName());
+    BOOST_CHECK_GT(store.getSegmentCount(), 1);
+  }
+
+  // torn append at the end of the active segment
+  size_t segmentCount = 0;
+  while (boost::filesystem::exists(path / ("segment-" + std::string(7, '0') + std::to_string(segmentCount) + ".log")))
+    ++segmentCount;
+  auto lastSegment = path / ("segment-" + std::string(7, '0') + std::to_string(segmentCount - 1) + ".log");
+  auto goodSize = boost::filesystem::file_size(lastSegment);
+  {
+    std::ofstream os(lastSegment.string(), std::ios::binary | std::ios::app);
+    os << "MGRL partial record";
+  }
+
+  LogStore store(path.string(), 1000);
+  BOOST_CHECK_EQUAL(store.size(), packets.size() - 1);
+  BOOST_CHECK_EQUAL(boost::filesystem::file_size(lastSegment), goodSize);
+  BOOST_CHECK(store.read(packets[3].getName()) == nullptr);
+  for (size_t i = 0; i < packets.size(); ++i) {
+    if (i == 3)
+      continue;
+    auto found = store.read(packets[i].getName());
+    BOOST_REQUIRE(found != nullptr);
+    BOOST_CHECK(found->wireEncode() == packets[i].wireEncode());
+  }
+
+  // appends continue after the last good record
+  auto extra = makeData("/stream/DATA/extra");
+  store.insert(extra);
+  BOOST_CHECK(store.read(extra.getName()) != nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(Retention)
+{
+  RetentionPolicy policy;
+  policy.setTtl("/gps", time::hours(1));
+  auto getTtl = [&] (const Name& name) { return policy.getTtl(name); };
+
+  std::vector<Data> kept;
+  {
+    // 4 records per segment, half of them expire
+    LogStore store(path.string(), 1000);
+    store.setTtlFunction(getTtl);
+    for (int i = 0; i < 10; ++i) {
+      store.insert(makeData(Name("/gps/DATA").appendNumber(i), 150));
+      kept.push_back(makeData(Name("/bat/DATA").appendNumber(i), 150));
+      store.insert(kept.back());
+    }
+
+    advanceClocks(time::minutes(30));
+    BOOST_CHECK_EQUAL(store.expire(100), 0);
+    advanceClocks(time::minutes(31));
+    // erased a few at a time
+    BOOST_CHECK_EQUAL(store.expire(6), 6);
+    BOOST_CHECK_EQUAL(store.expire(6), 4);
+    BOOST_CHECK_EQUAL(store.size(), 10);
+    BOOST_CHECK(store.read("/gps/DATA/%00") == nullptr);
+
+    // sealed segments are half garbage now
+    auto sizeBefore = store.getStorageSize();
+    while (store.compact(500) > 0);
+    BOOST_CHECK_LT(store.getStorageSize(), sizeBefore);
+    for (const auto& data : kept) {
+      auto found = store.read(data.getName());
+      BOOST_REQUIRE(found != nullptr);
+      BOOST_CHECK(found->wireEncode() == data.wireEncode());
+    }
+  }
+
+  // compaction left gaps in the segment numbers, expired packets stay gone without a TTL
+  LogStore store(path.string(), 1000);
+  BOOST_CHECK_EQUAL(store.size(), 10);
+  BOOST_CHECK(store.read("/gps/DATA/%00") == nullptr);
+
+  // copied records keep their insertion time
+  policy.setTtl("/bat", time::hours(2));
+  store.setTtlFunction(getTtl);
+  BOOST_CHECK_EQUAL(store.expire(100), 0);
+  advanceClocks(time::minutes(60));
+  BOOST_CHECK_EQUAL(store.expire(100), 10);
+  BOOST_CHECK_EQUAL(store.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(ExpireInDeadlineOrder)
+{
+  RetentionPolicy policy;
+  policy.setTtl("/a", time::hours(2));
+  policy.setTtl("/b", time::hours(1));
+
+  LogStore store(path.string(), 1000);
+  store.setTtlFunction([&] (const Name& name) { return policy.getTtl(name); });
+  // kept forever, doesn't hold up the others
+  store.insert(makeData("/0/DATA/0"));
+  store.insert(makeData("/a/DATA/0"));
+  advanceClocks(time::minutes(30));
+  store.insert(makeData("/b/DATA/0"));
+
+  advanceClocks(time::minutes(65));
+  BOOST_CHECK_EQUAL(store.expire(100), 1);
+  BOOST_CHECK(store.read("/b/DATA/0") == nullptr);
+  BOOST_CHECK(store.read("/a/DATA/0") != nullptr);
+
+  // a newer packet with the same name is due later
+  store.insert(makeData("/a/DATA/0"));
+  advanceClocks(time::minutes(30));
+  BOOST_CHECK_EQUAL(store.expire(100), 0);
+  BOOST_CHECK_EQUAL(store.size(), 2);
+
+  store.setTtlFunction(nullptr);
+  advanceClocks(time::hours(2));
+  BOOST_CHECK_EQUAL(store.expire(100), 0);
+  BOOST_CHECK_EQUAL(store.size(), 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestLogStore
+
+} // tests
+} // repo
+} // mguard
@@ -0,0 +1,230 @@
+#include "../test-common.hpp"
+
+#include <manifest.hpp>
+#include <common.hpp>
+#include <server/util/stream.hpp>
+
+#include <ndn-cxx/security/validator-config.hpp>
+#include <ndn-cxx/util/io.hpp>
+#include <ndn-cxx/util/sha256.hpp>
+
+#include <fstream>
+#include <regex>
+
+using namespace ndn;
+
+namespace mguard {
+namespace manifest {
+namespace tests {
+
+static std::vector<Name>
+makeEntries(size_t count)
+{
+  std::vector<Name> entries;
+  for (size_t i = 0; i < count; ++i) {
+    Name name("/ndn/org/md2k/mguard/dd40c/phone/battery/DATA");
+    name.appendNumber(i);
+    auto digest = ndn::util::Sha256::computeDigest(name.wireEncode().wire(), name.wireEncode().size());
+    name.appendImplicitSha256Digest(digest);
+    entries.push_back(name);
+  }
+  return entries;
+}
+
+BOOST_AUTO_TEST_SUITE(TestManifest)
+
+BOOST_AUTO_TEST_CASE(CompactEncoding)
+{
+  auto entries = makeEntries(50);
+  auto prefix = getCommonPrefix(entries);
+  BOOST_CHECK_EQUAL(prefix, Name("/ndn/org/md2k/mguard/dd40c/phone/battery/DATA"));
+
+  // a single entry keeps its digest as suffix
+  BOOST_CHECK_EQUAL(getCommonPrefix(makeEntries(1)), entries[0].getPrefix(-1));
+
+  auto encode = [&] (bool compact) {
+    EncodingBuffer encoder;
+    size_t totalLength = 0;
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+      totalLength += compact ? prependComponents(encoder, tlv::mGuardManifestEntry, *it, prefix.size())
+                             : it->wireEncode(encoder);
+    }
+    if (compact)
+      totalLength += prependComponents(encoder, tlv::mGuardManifestPrefix, prefix);
+    encoder.prependVarNumber(totalLength);
+    encoder.prependVarNumber(tlv::mGuardPublisher);
+    return encoder.block();
+  };
+
+  auto full = encode(false);
+  auto compact = encode(true);
+  BOOST_CHECK_LT(compact.size(), full.size() * 2 / 3);
+
+  for (const auto& wire : {full, compact}) {
+    ManifestEntries decoded(wire);
+    BOOST_REQUIRE_EQUAL(decoded.size(), entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+      BOOST_CHECK_EQUAL(decoded.get(i), entries[i]);
+    }
+  }
+
+  // entry suffix without prefix
+  EncodingBuffer encoder;
+  size_t totalLength = prependComponents(encoder, tlv::mGuardManifestEntry, entries[0], prefix.size());
+  encoder.prependVarNumber(totalLength);
+  encoder.prependVarNumber(tlv::mGuardPublisher);
+  BOOST_CHECK_THROW(ManifestEntries{encoder.block()}, ndn::tlv::Error);
+}
+
+BOOST_AUTO_TEST_CASE(Index)
+{
+  auto bucketStart = time::fromUnixTimestamp(time::milliseconds(1651399200000)); // aligned to the interval
+  util::Stream stream("/ndn/org/md2k/mguard/dd40c/phone/battery");
+  BOOST_CHECK_EQUAL(stream.getIndexName(), "/ndn/org/md2k/mguard/dd40c/phone/battery/MANIFEST/INDEX");
+
+  BOOST_CHECK(!stream.updateIndex(1, bucketStart));
+  BOOST_CHECK(!stream.updateIndex(2, bucketStart + MANIFEST_INDEX_INTERVAL / 2));
+  BOOST_CHECK(!stream.updateIndex(3, bucketStart + MANIFEST_INDEX_INTERVAL - time::milliseconds(1)));
+
+  // first manifest of the next bucket completes the index
+  auto index = stream.updateIndex(4, bucketStart + MANIFEST_INDEX_INTERVAL);
+  BOOST_REQUIRE(index);
+  BOOST_CHECK_EQUAL(index->firstSeq, 1);
+  BOOST_CHECK_EQUAL(index->lastSeq, 3);
+  BOOST_CHECK(index->startTime == bucketStart);
+  BOOST_CHECK(index->endTime == bucketStart + MANIFEST_INDEX_INTERVAL - time::milliseconds(1));
+
+  ManifestIndex decoded;
+  decoded.wireDecode(index->wireEncode());
+  BOOST_CHECK_EQUAL(decoded.firstSeq, index->firstSeq);
+  BOOST_CHECK_EQUAL(decoded.lastSeq, index->lastSeq);
+  BOOST_CHECK(decoded.startTime == index->startTime);
+  BOOST_CHECK(decoded.endTime == index->endTime);
+
+  // buckets without manifests are skipped
+  index = stream.updateIndex(5, bucketStart + MANIFEST_INDEX_INTERVAL * 5);
+  BOOST_REQUIRE(index);
+  BOOST_CHECK_EQUAL(index->firstSeq, 4);
+  BOOST_CHECK_EQUAL(index->lastSeq, 4);
+
+  BOOST_CHECK_THROW(decoded.wireDecode(Block(tlv::mGuardPublisher)), ndn::tlv::Error);
+}
+
+BOOST_AUTO_TEST_CASE(Catalog)
+{
+  StreamCatalog catalog;
+  catalog.version = 1700000000123;
+  catalog.streams = {"/ndn/org/md2k/mguard/dd40c/phone/gps", "/ndn/org/md2k/mguard/dd40c/phone/battery"};
+
+  StreamCatalog decoded;
+  decoded.wireDecode(catalog.wireEncode());
+  BOOST_CHECK_EQUAL(decoded.version, catalog.version);
+  BOOST_CHECK(decoded.streams == catalog.streams);
+
+  // empty catalog of a producer that hasn't seen any stream yet
+  decoded.wireDecode(StreamCatalog{}.wireEncode());
+  BOOST_CHECK_EQUAL(decoded.version, 0);
+  BOOST_CHECK(decoded.streams.empty());
+
+  BOOST_CHECK_THROW(decoded.wireDecode(Block(tlv::mGuardCatalog)), ndn::tlv::Error);
+  BOOST_CHECK_THROW(decoded.wireDecode(Block(tlv::mGuardManifestIndex)), ndn::tlv::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestManifest
+
+class CatalogSchemaFixture : public mguard::tests::IdentityTimeFixture
+{
+public:
+  CatalogSchemaFixture()
+    : face(io, m_keyChain, {true, true})
+    , validator(face)
+  {
+    auto root = addIdentity("/ndn/org/md2k");
+    auto producer = addSubCertificate("/ndn/org/md2k/mguard/producer", root);
+    producerCert = producer.getDefaultKey().getDefaultCertificate();
+
+    // manifest signing key as the publisher creates it (MANIFEST_SIGNER ECDSA)
+    manifestCert = getManifestCertificate(m_keyChain, producerCert);
+
+    // the shipped schema, anchored at the test root instead of the md2k anchor
+    std::ifstream file("certs/trust-schema.conf");
+    BOOST_REQUIRE(file);
+    std::string schema((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::ostringstream anchor;
+    io::save(root.getDefaultKey().getDefaultCertificate(), anchor);
+    std::string anchorBase64 = std::regex_replace(anchor.str(), std::regex("\n"), "");
+    schema = std::regex_replace(schema, std::regex("trust-anchor[^}]*\\}"),
+                                "trust-anchor { type base64 base64-string \"" + anchorBase64 + "\" }");
+    validator.load(schema, "trust-schema.conf");
+
+    // serve the certificates of the chain
+    face.onSendInterest.connect([this] (const Interest& interest) {
+      for (const auto* cert : {&producerCert, &manifestCert}) {
+        if (interest.matchesData(*cert)) {
+          io.post([this, cert] { face.receive(*cert); });
+          return;
+        }
+      }
+    });
+  }
+
+public:
+  ndn::util::DummyClientFace face;
+  security::ValidatorConfig validator;
+  security::Certificate producerCert;
+  security::Certificate manifestCert;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestCatalogSchema, CatalogSchemaFixture)
+
+BOOST_AUTO_TEST_CASE(ValidateCatalog)
+{
+  StreamCatalog catalog;
+  catalog.version = 1700000000123;
+  catalog.streams = {"/ndn/org/md2k/mguard/producer/phone/gps"};
+
+  // <producer>/CATALOG/<version>/<segment>, signed like the publisher does
+  Name segmentName("/ndn/org/md2k/mguard/producer");
+  segmentName.append(STREAM_CATALOG_COMPONENT).appendVersion(catalog.version).appendSegment(0);
+  Data segment(segmentName);
+  segment.setContent(catalog.wireEncode());
+  segment.setFinalBlock(name::Component::fromSegment(0));
+  m_keyChain.sign(segment, security::signingByCertificate(manifestCert));
+
+  bool isValid = false;
+  validator.validate(segment,
+                     [&] (const Data&) { isValid = true; },
+                     [] (const Data&, const security::ValidationError& error) {
+                       BOOST_ERROR("Catalog failed to validate: " << error);
+                     });
+  advanceClocks(time::milliseconds(10), 100);
+  BOOST_CHECK(isValid);
+}
+
+BOOST_AUTO_TEST_CASE(ManifestCertificate)
+{
+  auto producer = m_keyChain.getPib().getIdentity("/ndn/org/md2k/mguard/producer");
+  BOOST_CHECK_EQUAL(producer.getKeys().size(), 2);
+  BOOST_CHECK_EQUAL(manifestCert.getIssuerId(), name::Component(MANIFEST_CERT_ISSUER));
+  BOOST_CHECK_EQUAL(manifestCert.getKeyLocator()->getName(), producerCert.getName());
+  BOOST_CHECK(producer.getKey(manifestCert.getKeyName()).getKeyType() == KeyType::EC);
+
+  // reused on the next run, no new key
+  auto reused = getManifestCertificate(m_keyChain, producerCert);
+  BOOST_CHECK_EQUAL(reused.getName(), manifestCert.getName());
+  BOOST_CHECK_EQUAL(producer.getKeys().size(), 2);
+
+  // the default (EC) key of the producer is not a manifest key, a new one is created
+  auto other = addSubCertificate("/ndn/org/md2k/mguard/other", m_keyChain.getPib().getIdentity("/ndn/org/md2k"));
+  auto otherProducerCert = other.getDefaultKey().getDefaultCertificate();
+  auto otherCert = getManifestCertificate(m_keyChain, otherProducerCert);
+  BOOST_CHECK_NE(otherCert.getKeyName(), otherProducerCert.getKeyName());
+  BOOST_CHECK_EQUAL(otherCert.getIssuerId(), name::Component(MANIFEST_CERT_ISSUER));
+  BOOST_CHECK_EQUAL(other.getKeys().size(), 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestCatalogSchema
+
+} // tests
+} // manifest
+} // mguard
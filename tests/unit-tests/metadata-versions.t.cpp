@@ -0,0 +1,77 @@
+#include "../test-common.hpp"
+
+#include <server/util/metadata-versions.hpp>
+
+using namespace ndn;
+
+namespace mguard {
+namespace util {
+namespace tests {
+
+const std::string HEADER_A = R"({"name": "gps", "data_descriptor": [{"name": "latitude", "type": "float"}]})";
+const std::string HEADER_B = R"({"name": "gps", "data_descriptor": [{"name": "longitude", "type": "float"}]})";
+
+BOOST_FIXTURE_TEST_SUITE(TestMetadataVersions, mguard::tests::IdentityTimeFixture)
+
+BOOST_AUTO_TEST_CASE(PublishOncePerHeader)
+{
+  MetadataVersions versions;
+  BOOST_CHECK_EQUAL(versions.getVersion(0), 0);
+
+  auto first = versions.prepare(0, HEADER_A);
+  BOOST_REQUIRE(first);
+  BOOST_CHECK_EQUAL(*first, time::toUnixTimestamp(time::system_clock::now()).count());
+  // not published yet (e.g. the producer isn't ready), still a change
+  BOOST_CHECK(versions.prepare(0, HEADER_A) == first);
+  versions.commit(0, *first);
+  BOOST_CHECK_EQUAL(versions.getVersion(0), *first);
+
+  advanceClocks(time::seconds(1));
+  BOOST_CHECK(!versions.prepare(0, HEADER_A));
+  BOOST_CHECK(!versions.prepare(0, HEADER_A));
+  BOOST_CHECK_EQUAL(versions.getVersion(0), *first);
+
+  // streams are independent
+  BOOST_CHECK(versions.prepare(1, HEADER_A));
+  BOOST_CHECK_EQUAL(versions.getVersion(1), 0);
+
+  auto second = versions.prepare(0, HEADER_B);
+  BOOST_REQUIRE(second);
+  BOOST_CHECK_GT(*second, *first);
+  versions.commit(0, *second);
+  BOOST_CHECK(!versions.prepare(0, HEADER_B));
+
+  // back to the earlier header is a change again
+  BOOST_CHECK(versions.prepare(0, HEADER_A));
+}
+
+BOOST_AUTO_TEST_CASE(ClockStepsBack)
+{
+  MetadataVersions versions;
+  auto first = versions.prepare(0, HEADER_A);
+  BOOST_REQUIRE(first);
+  versions.commit(0, *first);
+
+  systemClock->setNow(time::toUnixTimestamp(time::system_clock::now() - time::hours(1)));
+  auto second = versions.prepare(0, HEADER_B);
+  BOOST_REQUIRE(second);
+  BOOST_CHECK_EQUAL(*second, *first + 1);
+  versions.commit(0, *second);
+
+  auto third = versions.prepare(0, HEADER_A);
+  BOOST_REQUIRE(third);
+  BOOST_CHECK_EQUAL(*third, *first + 2);
+  versions.commit(0, *third);
+
+  // the clock is used again once it is ahead
+  advanceClocks(time::hours(2));
+  auto fourth = versions.prepare(0, HEADER_B);
+  BOOST_REQUIRE(fourth);
+  BOOST_CHECK_EQUAL(*fourth, time::toUnixTimestamp(time::system_clock::now()).count());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace util
+} // namespace mguard
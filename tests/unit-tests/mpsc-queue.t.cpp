@@ -0,0 +1,83 @@
+#include "../test-common.hpp"
+
+#include <server/util/mpsc-queue.hpp>
+
+#include <thread>
+
+namespace mguard {
+namespace util {
+namespace tests {
+
+BOOST_FIXTURE_TEST_SUITE(TestMpscQueue, mguard::tests::IdentityTimeFixture)
+
+BOOST_AUTO_TEST_CASE(PushPop)
+{
+  MpscQueue<std::string> queue(3);
+  BOOST_CHECK_EQUAL(queue.capacity(), 4);
+
+  std::string value;
+  BOOST_CHECK(!queue.tryPop(value));
+
+  for (int i = 0; i < 4; ++i) {
+    BOOST_CHECK(queue.tryPush(std::to_string(i)));
+  }
+  // full, the value is not taken
+  std::string extra = "extra";
+  BOOST_CHECK(!queue.tryPush(std::move(extra)));
+  BOOST_CHECK_EQUAL(extra, "extra");
+  BOOST_CHECK_EQUAL(queue.size(), 4);
+
+  // in order, and the cells are reused once popped
+  for (int round = 0; round < 3; ++round) {
+    BOOST_CHECK(queue.tryPop(value));
+    BOOST_CHECK_EQUAL(value, std::to_string(round));
+    BOOST_CHECK(queue.tryPush(std::to_string(round + 4)));
+  }
+  for (int i = 3; i < 7; ++i) {
+    BOOST_CHECK(queue.tryPop(value));
+    BOOST_CHECK_EQUAL(value, std::to_string(i));
+  }
+  BOOST_CHECK(!queue.tryPop(value));
+  BOOST_CHECK_EQUAL(queue.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(ManyProducers)
+{
+  const int nProducers = 4;
+  const int nValues = 10000;
+  MpscQueue<std::pair<int, int>> queue(64);
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < nProducers; ++p) {
+    producers.emplace_back([&queue, p] {
+      for (int i = 0; i < nValues; ++i) {
+        while (!queue.tryPush({p, i}))
+          std::this_thread::yield();
+      }
+    });
+  }
+
+  // values of each producer arrive in the order it pushed them
+  std::vector<int> next(nProducers, 0);
+  std::pair<int, int> value;
+  for (int nPopped = 0; nPopped < nProducers * nValues;) {
+    if (!queue.tryPop(value)) {
+      std::this_thread::yield();
+      continue;
+    }
+    BOOST_REQUIRE_EQUAL(value.second, next[value.first]);
+    ++next[value.first];
+    ++nPopped;
+  }
+
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  BOOST_CHECK(!queue.tryPop(value));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace util
+} // namespace mguard
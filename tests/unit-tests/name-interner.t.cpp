@@ -0,0 +1,49 @@
+#include "../test-common.hpp"
+
+#include <server/util/name-interner.hpp>
+
+using namespace ndn;
+
+namespace mguard {
+namespace util {
+namespace tests {
+
+BOOST_FIXTURE_TEST_SUITE(TestNameInterner, mguard::tests::IdentityTimeFixture)
+
+BOOST_AUTO_TEST_CASE(Intern)
+{
+  NameInterner names;
+  BOOST_CHECK_EQUAL(names.size(), 0);
+
+  Name gps("/ndn/org/md2k/mguard/dd40c/phone/gps");
+  Name home("/ndn/org/md2k/ATTRIBUTE/location/home");
+
+  // ids are dense and handed out in order
+  BOOST_CHECK_EQUAL(names.intern(gps), 0);
+  BOOST_CHECK_EQUAL(names.intern(home), 1);
+  BOOST_CHECK_EQUAL(names.intern(gps), 0);
+  BOOST_CHECK_EQUAL(names.size(), 2);
+
+  BOOST_CHECK(names.find(home) == 1);
+  BOOST_CHECK(!names.find("/ndn/org/md2k/battery"));
+
+  BOOST_CHECK_EQUAL(names.getName(0), gps);
+  BOOST_CHECK_EQUAL(names.getUri(1), home.toUri());
+  BOOST_CHECK(names.getWire(0) == gps.wireEncode());
+
+  // references stay valid while more names get interned
+  const auto& uri = names.getUri(0);
+  for (int i = 0; i < 100; ++i) {
+    names.intern(Name(gps).appendNumber(i));
+  }
+  BOOST_CHECK_EQUAL(uri, gps.toUri());
+  BOOST_CHECK_EQUAL(names.size(), 102);
+
+  BOOST_CHECK_THROW(names.getName(102), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace util
+} // namespace mguard
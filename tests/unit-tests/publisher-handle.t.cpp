@@ -0,0 +1,103 @@
+#include "../test-common.hpp"
+
+#include <common.hpp>
+#include <server/publisher-handle.hpp>
+
+#include <atomic>
+#include <thread>
+
+using namespace ndn;
+
+namespace mguard {
+namespace tests {
+
+class PublisherHandleFixture : public IdentityTimeFixture
+{
+public:
+  PublisherHandleFixture()
+    : queue(std::make_shared<IngestQueue>(io, 8))
+    , handle(queue)
+  {
+  }
+
+  void
+  start()
+  {
+    queue->start([this] (IngestBatch& batch) {
+      published.push_back(batch.streamName + ":" + std::to_string(batch.rows.size()));
+    });
+  }
+
+public:
+  std::shared_ptr<IngestQueue> queue;
+  PublisherHandle handle;
+  std::vector<std::string> published;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestPublisherHandle, PublisherHandleFixture)
+
+BOOST_AUTO_TEST_CASE(Submit)
+{
+  BOOST_CHECK(handle.submit("ndn--org--md2k--gps", "header", {"1,a", "2,b"}));
+  advanceClocks(time::milliseconds(1), 5);
+  // not started yet, the batch waits
+  BOOST_CHECK(published.empty());
+
+  start();
+  BOOST_CHECK_EQUAL(published.size(), 1);
+  BOOST_CHECK_EQUAL(published.front(), "ndn--org--md2k--gps:2");
+
+  BOOST_CHECK(handle.submit("ndn--org--md2k--battery", "header", {"1,a"}));
+  BOOST_CHECK_EQUAL(published.size(), 1);
+  advanceClocks(time::milliseconds(1), 5);
+  BOOST_CHECK_EQUAL(published.size(), 2);
+  BOOST_CHECK_EQUAL(published.back(), "ndn--org--md2k--battery:1");
+  BOOST_CHECK_EQUAL(queue->getSubmittedCount(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(Full)
+{
+  for (size_t i = 0; i < queue->capacity(); ++i) {
+    BOOST_CHECK(handle.submit("ndn--org--md2k--gps", "header", {}, SubmitMode::NON_BLOCKING));
+  }
+  BOOST_CHECK(!handle.submit("ndn--org--md2k--gps", "header", {}, SubmitMode::NON_BLOCKING));
+  BOOST_CHECK_EQUAL(queue->getRejectedCount(), 1);
+
+  start();
+  BOOST_CHECK_EQUAL(published.size(), queue->capacity());
+  BOOST_CHECK(handle.submit("ndn--org--md2k--gps", "header", {}, SubmitMode::NON_BLOCKING));
+}
+
+BOOST_AUTO_TEST_CASE(ManyThreads)
+{
+  start();
+  const size_t nThreads = 4;
+  const size_t nBatches = 200;
+
+  std::atomic<size_t> nDone{0};
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < nThreads; ++t) {
+    threads.emplace_back([this, t, &nDone] {
+      auto threadHandle = handle;
+      for (size_t i = 0; i < nBatches; ++i) {
+        threadHandle.submit("stream-" + std::to_string(t), "header", {std::to_string(i)});
+      }
+      ++nDone;
+    });
+  }
+
+  // the submitting threads block on the full queue until this thread drains it
+  while (nDone < nThreads || published.size() < nThreads * nBatches) {
+    advanceClocks(time::milliseconds(1));
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  BOOST_CHECK_EQUAL(published.size(), nThreads * nBatches);
+  BOOST_CHECK_EQUAL(queue->getSubmittedCount(), nThreads * nBatches);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace mguard
@@ -0,0 +1,87 @@
+#include "../test-common.hpp"
+
+#include <server/util/repo-connection.hpp>
+
+#include <chrono>
+#include <thread>
+
+using namespace ndn;
+
+namespace mguard {
+namespace util {
+namespace tests {
+
+class RepoConnectionFixture : public mguard::tests::IdentityTimeFixture
+{
+public:
+  RepoConnectionFixture()
+    : acceptor(io, bp::tcp::endpoint(bp::address_v4::loopback(), 0))
+    , endpoint{"127.0.0.1", std::to_string(acceptor.local_endpoint().port())}
+  {
+  }
+
+  // the socket operations are real, their handlers are run as they complete
+  template<typename Predicate>
+  bool
+  pollUntil(Predicate predicate)
+  {
+    for (int i = 0; i < 1000 && !predicate(); ++i) {
+      io.restart();
+      io.poll();
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return predicate();
+  }
+
+  // handlers aborted by the destruction of the connection
+  void
+  runAborted()
+  {
+    io.restart();
+    io.run();
+  }
+
+public:
+  bp::tcp::acceptor acceptor;
+  RepoEndpoint endpoint;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestRepoConnection, RepoConnectionFixture)
+
+BOOST_AUTO_TEST_CASE(DestroyWhileConnecting)
+{
+  bool isConnectCalled = false;
+  auto connection = std::make_unique<RepoConnection>(io, 1, time::milliseconds(10));
+  connection->connect(endpoint, [&] (const auto&) { isConnectCalled = true; });
+  connection.reset();
+
+  runAborted();
+  BOOST_CHECK(!isConnectCalled);
+}
+
+BOOST_AUTO_TEST_CASE(DestroyWhileWriting)
+{
+  auto connection = std::make_unique<RepoConnection>(io, 1, time::milliseconds(10));
+  bool isConnected = false;
+  connection->connect(endpoint, [&] (const auto& err) { isConnected = !err; });
+  BOOST_REQUIRE(pollUntil([&] { return isConnected; }));
+
+  // the repo never reads, the write can't complete
+  bool isWriteCalled = false;
+  Block wire(ndn::tlv::Content, std::make_shared<Buffer>(64 * 1024 * 1024));
+  connection->write(wire, "/stream/DATA/0", [&] (const auto&, const auto&) { isWriteCalled = true; });
+  io.restart();
+  io.poll();
+  BOOST_CHECK_EQUAL(connection->getQueueSize(), 1);
+  BOOST_CHECK_EQUAL(connection->getWrittenCount(), 0);
+  connection.reset();
+
+  runAborted();
+  BOOST_CHECK(!isWriteCalled);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace util
+} // namespace mguard
@@ -0,0 +1,125 @@
+#include "../test-common.hpp"
+
+#include <server/util/spill-journal.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+
+using namespace ndn;
+
+namespace mguard {
+namespace util {
+namespace tests {
+
+class SpillJournalFixture : public mguard::tests::IdentityTimeFixture
+{
+public:
+  SpillJournalFixture()
+    : path(boost::filesystem::path(TMP_TESTS_PATH) / "spill-journal" / "connection-0.journal")
+  {
+    boost::filesystem::remove_all(path.parent_path());
+  }
+
+  ~SpillJournalFixture()
+  {
+    boost::filesystem::remove_all(path.parent_path());
+  }
+
+  Block
+  makeWire(uint64_t seq)
+  {
+    Data data(Name("/stream/DATA").appendNumber(seq));
+    data.setContent(std::vector<uint8_t>(100, 0xAB));
+    m_keyChain.sign(data, security::signingWithSha256());
+    return data.wireEncode();
+  }
+
+public:
+  boost::filesystem::path path;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestSpillJournal, SpillJournalFixture)
+
+BOOST_AUTO_TEST_CASE(ReplayInOrder)
+{
+  SpillJournal journal(path.string());
+  BOOST_CHECK(journal.empty());
+  for (int i = 0; i < 3; ++i) {
+    journal.append(makeWire(i));
+  }
+  BOOST_CHECK(journal.hasUnsynced());
+  journal.sync();
+  BOOST_CHECK(!journal.hasUnsynced());
+
+  auto first = journal.next();
+  auto second = journal.next();
+  BOOST_REQUIRE(first && second);
+  BOOST_CHECK(*first == makeWire(0));
+  BOOST_CHECK(*second == makeWire(1));
+
+  // first one written, second one failed
+  journal.consume();
+  journal.rewind();
+  auto again = journal.next();
+  BOOST_REQUIRE(again);
+  BOOST_CHECK(*again == makeWire(1));
+  journal.consume();
+
+  BOOST_REQUIRE(journal.hasNext());
+  journal.next();
+  BOOST_CHECK(!journal.hasNext());
+  BOOST_CHECK(!journal.empty());
+  journal.consume();
+
+  // fully replayed journal is truncated
+  BOOST_CHECK(journal.empty());
+  BOOST_CHECK_EQUAL(boost::filesystem::file_size(path), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Recovery)
+{
+  {
+    SpillJournal journal(path.string());
+    journal.append(makeWire(0));
+    journal.append(makeWire(1));
+  }
+  auto goodSize = boost::filesystem::file_size(path);
+  {
+    std::ofstream os(path.string(), std::ios::binary | std::ios::app);
+    os << "partial record";
+  }
+
+  SpillJournal journal(path.string());
+  BOOST_CHECK_EQUAL(journal.getPendingBytes(), goodSize);
+  BOOST_CHECK_EQUAL(boost::filesystem::file_size(path), goodSize);
+  BOOST_CHECK(*journal.next() == makeWire(0));
+  BOOST_CHECK(*journal.next() == makeWire(1));
+  BOOST_CHECK(!journal.next());
+}
+
+BOOST_AUTO_TEST_CASE(GarbageHeader)
+{
+  {
+    SpillJournal journal(path.string());
+    journal.append(makeWire(0));
+  }
+  auto goodSize = boost::filesystem::file_size(path);
+  {
+    // length of 4 GiB - 1, must be rejected before anything is allocated for it
+    std::ofstream os(path.string(), std::ios::binary | std::ios::app);
+    os << std::string(4, '\xff') << std::string(4, '\0') << "garbage";
+  }
+
+  SpillJournal journal(path.string());
+  BOOST_CHECK_EQUAL(journal.getPendingBytes(), goodSize);
+  BOOST_CHECK_EQUAL(boost::filesystem::file_size(path), goodSize);
+  BOOST_CHECK(*journal.next() == makeWire(0));
+  BOOST_CHECK(!journal.next());
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestSpillJournal
+
+} // tests
+} // util
+} // mguard
@@ -0,0 +1,89 @@
+#include "../test-common.hpp"
+
+#include <server/util/startup-barrier.hpp>
+
+using namespace ndn;
+using namespace ndn::time_literals;
+
+namespace mguard {
+namespace util {
+namespace tests {
+
+class StartupBarrierFixture : public mguard::tests::IdentityTimeFixture
+{
+public:
+  StartupBarrierFixture()
+    : scheduler(io)
+    , barrier(scheduler, {"repo", "aa", "prefix"})
+  {
+  }
+
+  void
+  wait()
+  {
+    barrier.wait([this] { ++nReady; },
+                 [this] (const std::string& reason) { failures.push_back(reason); },
+                 1_s);
+  }
+
+public:
+  Scheduler scheduler;
+  StartupBarrier barrier;
+  size_t nReady = 0;
+  std::vector<std::string> failures;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestStartupBarrier, StartupBarrierFixture)
+
+BOOST_AUTO_TEST_CASE(Ready)
+{
+  barrier.satisfy("repo"); // before anyone waits
+  wait();
+  barrier.satisfy("aa");
+  barrier.satisfy("aa");
+  BOOST_CHECK_EQUAL(nReady, 0);
+
+  barrier.satisfy("prefix");
+  BOOST_CHECK_EQUAL(nReady, 1);
+  BOOST_CHECK(barrier.isReady());
+
+  // no timeout once ready
+  advanceClocks(100_ms, 20);
+  BOOST_CHECK_EQUAL(nReady, 1);
+  BOOST_CHECK(failures.empty());
+}
+
+BOOST_AUTO_TEST_CASE(Timeout)
+{
+  wait();
+  barrier.satisfy("repo");
+  advanceClocks(100_ms, 9);
+  BOOST_CHECK(failures.empty());
+
+  advanceClocks(100_ms, 2);
+  BOOST_REQUIRE_EQUAL(failures.size(), 1);
+  BOOST_CHECK_NE(failures[0].find("aa, prefix"), std::string::npos);
+
+  // late conditions don't matter anymore
+  barrier.satisfy("aa");
+  barrier.satisfy("prefix");
+  BOOST_CHECK_EQUAL(nReady, 0);
+}
+
+BOOST_AUTO_TEST_CASE(Failure)
+{
+  barrier.fail("prefix", "failed to register /producer");
+  wait();
+  BOOST_REQUIRE_EQUAL(failures.size(), 1);
+  BOOST_CHECK_EQUAL(failures[0], "prefix: failed to register /producer");
+
+  advanceClocks(100_ms, 20);
+  BOOST_CHECK_EQUAL(failures.size(), 1);
+  BOOST_CHECK_EQUAL(nReady, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestStartupBarrier
+
+} // tests
+} // util
+} // mguard
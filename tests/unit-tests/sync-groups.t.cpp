@@ -0,0 +1,150 @@
+#include "../test-common.hpp"
+
+#include <common.hpp>
+#include <server/util/sync-groups.hpp>
+
+#include <ndn-cxx/util/dummy-client-face.hpp>
+
+using namespace ndn;
+using namespace ndn::time_literals;
+
+namespace mguard {
+namespace util {
+namespace tests {
+
+class SyncGroupsFixture : public mguard::tests::IdentityTimeFixture
+{
+public:
+  SyncGroupsFixture()
+    : face(io, m_keyChain)
+    , groups(face, m_keyChain, "/ndn/org/md2k", 20_ms)
+  {
+  }
+
+public:
+  ndn::util::DummyClientFace face;
+  SyncGroups groups;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestSyncGroups, SyncGroupsFixture)
+
+BOOST_AUTO_TEST_CASE(GroupPrefix)
+{
+  Name syncPrefix("/ndn/org/md2k");
+  BOOST_CHECK_EQUAL(getSyncGroupPrefix(syncPrefix, "/ndn/org/md2k/mguard/dd40c/phone/gps"),
+                    "/ndn/org/md2k/SYNC/mguard/dd40c/phone");
+  BOOST_CHECK_EQUAL(getSyncGroupPrefix(syncPrefix, "/ndn/org/md2k/mguard/dd40c/motion_sense/accelerometer/left_wrist"),
+                    "/ndn/org/md2k/SYNC/mguard/dd40c/motion_sense");
+  // the stream itself is never part of the group
+  BOOST_CHECK_EQUAL(getSyncGroupPrefix(syncPrefix, "/ndn/org/md2k/battery"), "/ndn/org/md2k/SYNC");
+  BOOST_CHECK_EQUAL(getSyncGroupPrefix(syncPrefix, "/other/a/b"), "/ndn/org/md2k/SYNC/other/a");
+}
+
+BOOST_AUTO_TEST_CASE(Versions)
+{
+  Name gps("/ndn/org/md2k/mguard/dd40c/phone/gps");
+  Name battery("/ndn/org/md2k/mguard/dd40c/phone/battery");
+  Name other("/ndn/org/md2k/mguard/aa01b/phone/gps");
+  Name phone("/ndn/org/md2k/SYNC/mguard/dd40c/phone");
+
+  BOOST_CHECK(groups.addPrefix(gps, Name(gps).append("MANIFEST")));
+  BOOST_CHECK(!groups.addPrefix(gps, Name(gps).append("MANIFEST")));
+  BOOST_CHECK(groups.addPrefix(battery, Name(battery).append("MANIFEST")));
+  BOOST_CHECK(groups.addPrefix(other, Name(other).append("MANIFEST")));
+  BOOST_CHECK_EQUAL(groups.size(), 2);
+  BOOST_CHECK_EQUAL(groups.getGroupOf(Name(battery).append("MANIFEST")).value(), phone);
+  BOOST_CHECK_EQUAL(groups.getGroupVersion(phone).value(), 2);
+  BOOST_CHECK_EQUAL(groups.getGroupVersion("/ndn/org/md2k/SYNC/mguard/aa01b/phone").value(), 1);
+
+  // publishing doesn't touch the version
+  groups.publishName(Name(gps).append("MANIFEST"), 5);
+  BOOST_CHECK_EQUAL(groups.getSeqNo(Name(gps).append("MANIFEST")).value(), 5);
+  BOOST_CHECK_EQUAL(groups.getGroupVersion(phone).value(), 2);
+  BOOST_CHECK(!groups.getSeqNo("/ndn/org/md2k/unknown"));
+
+  // announced next to the group versions, not a stream prefix
+  groups.announce("/ndn/org/md2k/CATALOG", 1700000000000);
+  BOOST_CHECK_EQUAL(groups.getGroupVersion("/ndn/org/md2k/CATALOG").value(), 1700000000000);
+  BOOST_CHECK(!groups.getSeqNo("/ndn/org/md2k/CATALOG"));
+  BOOST_CHECK_EQUAL(groups.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(Resize)
+{
+  Name phone("/ndn/org/md2k/SYNC/mguard/dd40c/phone");
+  Name first("/ndn/org/md2k/mguard/dd40c/phone/s0/MANIFEST");
+  groups.addPrefix("/ndn/org/md2k/mguard/dd40c/phone/s0", first);
+  groups.publishName(first, 7);
+
+  for (size_t i = 1; i <= SYNC_MIN_IBF_SIZE; ++i) {
+    Name stream("/ndn/org/md2k/mguard/dd40c/phone");
+    stream.append("s" + std::to_string(i));
+    groups.addPrefix(stream, Name(stream).append("MANIFEST"));
+  }
+
+  BOOST_CHECK_EQUAL(groups.getIbfSize(phone), getSyncStateSize(SYNC_MIN_IBF_SIZE + 1, SYNC_MIN_IBF_SIZE));
+  // sequence numbers survive the rebuild
+  BOOST_CHECK_EQUAL(groups.getSeqNo(first).value(), 7);
+  BOOST_CHECK_EQUAL(groups.getGroupVersion(phone).value(), SYNC_MIN_IBF_SIZE + 1);
+  BOOST_CHECK_EQUAL(groups.getIbfSize("/ndn/org/md2k"), SYNC_MIN_IBF_SIZE);
+}
+
+BOOST_AUTO_TEST_CASE(Coalesce)
+{
+  Name gps("/ndn/org/md2k/mguard/dd40c/phone/gps");
+  Name battery("/ndn/org/md2k/mguard/dd40c/phone/battery");
+  Name gpsManifest = Name(gps).append("MANIFEST");
+  Name batteryManifest = Name(battery).append("MANIFEST");
+  groups.addPrefix(gps, gpsManifest);
+  groups.addPrefix(battery, batteryManifest);
+  advanceClocks(10_ms, 3);
+  // one version bump per group and flush
+  BOOST_CHECK_EQUAL(groups.getSavedUpdates(), 1);
+
+  groups.publishName(gpsManifest, 1);
+  groups.publishName(gpsManifest, 2);
+  groups.publishName(batteryManifest, 1);
+  // visible before the window ends
+  BOOST_CHECK_EQUAL(groups.getSeqNo(gpsManifest).value(), 2);
+
+  advanceClocks(10_ms, 3);
+  BOOST_CHECK_EQUAL(groups.getSeqNo(gpsManifest).value(), 2);
+  BOOST_CHECK_EQUAL(groups.getSeqNo(batteryManifest).value(), 1);
+  BOOST_CHECK_EQUAL(groups.getSavedUpdates(), 3);
+
+  groups.publishName(batteryManifest, 2);
+  groups.flush();
+  BOOST_CHECK_EQUAL(groups.getSeqNo(batteryManifest).value(), 2);
+  BOOST_CHECK_EQUAL(groups.getSavedUpdates(), 3);
+
+  // called once per update, the collected sequence numbers are visible already
+  std::vector<uint64_t> seen;
+  groups.setBeforeUpdateCallback([&] { seen.push_back(groups.getSeqNo(gpsManifest).value()); });
+  groups.publishName(gpsManifest, 3);
+  groups.publishName(gpsManifest, 4);
+  BOOST_CHECK(seen.empty());
+  advanceClocks(10_ms, 3);
+  BOOST_REQUIRE_EQUAL(seen.size(), 1);
+  BOOST_CHECK_EQUAL(seen[0], 4);
+}
+
+BOOST_AUTO_TEST_CASE(BeforeUpdateWithoutWindow)
+{
+  SyncGroups immediate(face, m_keyChain, "/ndn/org/md2k/immediate", 0_ms);
+  Name gps("/ndn/org/md2k/immediate/mguard/dd40c/phone/gps");
+  Name gpsManifest = Name(gps).append("MANIFEST");
+  immediate.addPrefix(gps, gpsManifest);
+
+  std::vector<uint64_t> seen;
+  immediate.setBeforeUpdateCallback([&] { seen.push_back(immediate.getSeqNo(gpsManifest).value_or(0)); });
+  immediate.publishName(gpsManifest, 1);
+  BOOST_REQUIRE_EQUAL(seen.size(), 1);
+  BOOST_CHECK_EQUAL(seen[0], 1);
+  BOOST_CHECK_EQUAL(immediate.getSeqNo(gpsManifest).value(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace util
+} // namespace mguard
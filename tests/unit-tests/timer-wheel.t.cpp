@@ -0,0 +1,91 @@
+#include "../test-common.hpp"
+
+#include <server/util/timer-wheel.hpp>
+
+using namespace ndn;
+using namespace ndn::time_literals;
+
+namespace mguard {
+namespace util {
+namespace tests {
+
+class TimerWheelFixture : public mguard::tests::IdentityTimeFixture
+{
+public:
+  TimerWheelFixture()
+    : scheduler(io)
+    , wheel(scheduler, 10_ms, [this] (const std::vector<size_t>& expired) {
+        ++nCallbacks;
+        fired.insert(fired.end(), expired.begin(), expired.end());
+      })
+  {
+  }
+
+public:
+  Scheduler scheduler;
+  TimerWheel wheel;
+  std::vector<size_t> fired;
+  size_t nCallbacks = 0;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestTimerWheel, TimerWheelFixture)
+
+BOOST_AUTO_TEST_CASE(ScheduleAndMove)
+{
+  wheel.reserve(3);
+  wheel.schedule(0, 100_ms);
+  wheel.schedule(1, 50_ms);
+  wheel.schedule(2, 100_ms);
+  BOOST_CHECK_EQUAL(wheel.size(), 3);
+
+  // moving a deadline doesn't add a timer
+  wheel.schedule(1, 200_ms);
+  BOOST_CHECK_EQUAL(wheel.size(), 3);
+
+  advanceClocks(10_ms, 60_ms);
+  BOOST_CHECK(fired.empty());
+
+  // 0 and 2 expire on the same tick and are delivered together
+  advanceClocks(10_ms, 50_ms);
+  BOOST_CHECK_EQUAL(nCallbacks, 1);
+  BOOST_CHECK_EQUAL(fired.size(), 2);
+  BOOST_CHECK(wheel.isScheduled(1));
+
+  wheel.cancel(1);
+  advanceClocks(10_ms, 200_ms);
+  BOOST_CHECK_EQUAL(fired.size(), 2);
+  BOOST_CHECK_EQUAL(wheel.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Cascade)
+{
+  // beyond the first level (256 ticks)
+  wheel.schedule(7, 5000_ms);
+  wheel.schedule(8, 3_ms);
+
+  advanceClocks(10_ms, 4990_ms);
+  BOOST_CHECK_EQUAL(fired.size(), 1);
+  BOOST_CHECK_EQUAL(fired.front(), 8);
+
+  advanceClocks(10_ms, 20_ms);
+  BOOST_CHECK_EQUAL(fired.size(), 2);
+  BOOST_CHECK_EQUAL(fired.back(), 7);
+}
+
+BOOST_AUTO_TEST_CASE(ManyTimers)
+{
+  const size_t nTimers = 10000;
+  wheel.reserve(nTimers);
+  for (size_t i = 0; i < nTimers; ++i)
+    wheel.schedule(i, time::milliseconds(i % 1000));
+
+  advanceClocks(10_ms, 1100_ms);
+  BOOST_CHECK_EQUAL(fired.size(), nTimers);
+  BOOST_CHECK_LE(nCallbacks, 101);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestTimerWheel
+
+} // tests
+} // util
+} // mguard
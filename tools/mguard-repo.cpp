@@ -0,0 +1,227 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021-2023,  The University of Memphis
+ *
+ * This file is part of mGuard.
+ * See AUTHORS.md for complete list of mGuard authors and contributors.
+ *
+ * mGuard is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * mGuard is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with
+ * mGuard, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <server/repo/native-repo.hpp>
+#include <server/util/async-repo-inserter.hpp>
+#include <common.hpp>
+
+#include <ndn-cxx/util/logger.hpp>
+#include <ndn-cxx/face.hpp>
+
+#include <boost/asio.hpp>
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/variables_map.hpp>
+#include <boost/program_options/parsers.hpp>
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+NDN_LOG_INIT(mguard.tools.repo);
+
+namespace bp = boost::asio::ip;
+
+static void
+usage(const boost::program_options::options_description& options)
+{
+  std::cerr << "Usage: mguard-repo [options]\n" << options;
+  exit(2);
+}
+
+/*
+  Receives packets from a producer (AsyncRepoInserter) over TCP. The stream carries plain
+  Data TLVs back to back, as for the ndn-python-repo TCP bulk insertion.
+*/
+class RepoConnection : public std::enable_shared_from_this<RepoConnection>
+{
+public:
+  RepoConnection(boost::asio::io_service& io, mguard::repo::NativeRepo& repo)
+  : m_socket(io)
+  , m_repo(repo)
+  {
+  }
+
+  bp::tcp::socket&
+  socket()
+  {
+    return m_socket;
+  }
+
+  void
+  start()
+  {
+    m_socket.async_read_some(boost::asio::buffer(m_chunk),
+      [self = shared_from_this()] (const boost::system::error_code& err, size_t nBytes) {
+        if (err) {
+          NDN_LOG_DEBUG("Connection closed: " << err.message());
+          return;
+        }
+        self->m_pending.insert(self->m_pending.end(), self->m_chunk, self->m_chunk + nBytes);
+        if (!self->processPending()) {
+          NDN_LOG_ERROR("Invalid packet stream, closing the connection");
+          self->m_socket.close();
+          return;
+        }
+        self->start();
+      });
+  }
+
+private:
+  // store all complete packets, returns false if the stream is malformed
+  bool
+  processPending()
+  {
+    auto buffer = std::make_shared<const ndn::Buffer>(m_pending.begin(), m_pending.end());
+    size_t offset = 0;
+    while (offset < buffer->size()) {
+      bool isOk = false;
+      ndn::Block block;
+      std::tie(isOk, block) = ndn::Block::fromBuffer(buffer, offset);
+      if (!isOk)
+        break;
+      offset += block.size();
+
+      if (block.type() != ndn::tlv::Data) {
+        NDN_LOG_WARN("Ignoring TLV of type: " << block.type());
+        continue;
+      }
+      try {
+        m_repo.insert(ndn::Data(block));
+      }
+      catch (const std::exception& e) {
+        NDN_LOG_ERROR("Failed to store packet: " << e.what());
+      }
+    }
+    m_pending.erase(m_pending.begin(), m_pending.begin() + offset);
+    // an incomplete packet can't be larger than the largest packet
+    return m_pending.size() <= ndn::MAX_NDN_PACKET_SIZE;
+  }
+
+private:
+  bp::tcp::socket m_socket;
+  mguard::repo::NativeRepo& m_repo;
+  uint8_t m_chunk[ndn::MAX_NDN_PACKET_SIZE];
+  std::vector<uint8_t> m_pending;
+};
+
+class RepoServer
+{
+public:
+  RepoServer(ndn::Face& face, mguard::repo::NativeRepo& repo, uint16_t port)
+  : m_io(face.getIoService())
+  , m_repo(repo)
+  , m_acceptor(m_io, bp::tcp::endpoint(bp::tcp::v4(), port))
+  {
+    NDN_LOG_INFO("Accepting packets on TCP port: " << port);
+    startAccept();
+  }
+
+private:
+  void
+  startAccept()
+  {
+    auto connection = std::make_shared<RepoConnection>(m_io, m_repo);
+    m_acceptor.async_accept(connection->socket(), [this, connection] (const boost::system::error_code& err) {
+      if (!err) {
+        NDN_LOG_DEBUG("New connection from: " << connection->socket().remote_endpoint());
+        connection->start();
+      }
+      startAccept();
+    });
+  }
+
+private:
+  boost::asio::io_service& m_io;
+  mguard::repo::NativeRepo& m_repo;
+  bp::tcp::acceptor m_acceptor;
+};
+
+int
+main(int argc, char* argv[])
+{
+  std::vector<std::string> storagePaths;
+  std::vector<std::string> prefixes;
+  std::vector<std::string> ttls;
+  uint64_t defaultTtl = 0;
+  uint16_t port = std::stoi(mguard::util::DEFAULT_PORT);
+
+  namespace po = boost::program_options;
+  po::options_description visibleOptDesc("Options");
+
+  visibleOptDesc.add_options()
+    ("help,h",      "print this message and exit")
+    ("storage,d", po::value<std::vector<std::string>>(&storagePaths),
+      "directory of the log segments, repeat for several storage shards (e.g. one per disk)")
+    ("prefix,p", po::value<std::vector<std::string>>(&prefixes)->required(),
+      "prefix to serve, can be repeated, e.g. /ndn/org/md2k")
+    ("port,P", po::value<uint16_t>(&port), "TCP port to receive packets on")
+    ("ttl,t", po::value<std::vector<std::string>>(&ttls),
+      "<prefix>=<hours>, packets under the prefix are deleted after this long, can be repeated")
+    ("default-ttl,T", po::value<uint64_t>(&defaultTtl),
+      "hours after which packets matching no --ttl prefix are deleted, kept forever if not given")
+  ;
+
+  try
+  {
+    po::variables_map optVm;
+    po::store(po::parse_command_line(argc, argv, visibleOptDesc), optVm);
+    if (optVm.count("help"))
+      usage(visibleOptDesc);
+    po::notify(optVm);
+  }
+  catch (const po::error& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    usage(visibleOptDesc);
+  }
+
+  if (storagePaths.empty())
+    storagePaths.push_back(mguard::NATIVE_REPO_PATH);
+
+  mguard::repo::RetentionPolicy retentionPolicy;
+  if (defaultTtl > 0)
+    retentionPolicy.setDefaultTtl(ndn::time::hours(defaultTtl));
+  for (const auto& ttl : ttls) {
+    auto pos = ttl.rfind('=');
+    try {
+      if (pos == std::string::npos)
+        throw std::invalid_argument("missing '='");
+      retentionPolicy.setTtl(ttl.substr(0, pos), ndn::time::hours(std::stoull(ttl.substr(pos + 1))));
+    }
+    catch (const std::exception& e) {
+      std::cerr << "ERROR: invalid --ttl " << ttl << ": " << e.what() << std::endl;
+      usage(visibleOptDesc);
+    }
+  }
+
+  try {
+    ndn::Face face;
+    mguard::repo::NativeRepo repo(face, storagePaths, mguard::REPO_SEGMENT_SIZE, mguard::REPO_SYNC_INTERVAL);
+    repo.setRetentionPolicy(retentionPolicy);
+    for (const auto& prefix : prefixes)
+      repo.listen(prefix);
+
+    RepoServer server(face, repo, port);
+    face.processEvents();
+  }
+  catch (const std::exception& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 1;
+  }
+}